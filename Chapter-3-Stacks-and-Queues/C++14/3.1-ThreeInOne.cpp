@@ -0,0 +1,392 @@
+// Three in One: Describe how you could use a single array to implement three stacks.
+//
+// C++14 version of 3.1-Three-in-One/FixedMultiStack, generalised to any element type and
+// any number of stacks. A full stack no longer refuses the push while the others have
+// room: the regions of the other stacks are shifted to hand it spare capacity.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "benchmark.hpp"
+
+// NumStacks stacks stored in consecutive regions of one buffer. When a stack runs out of
+// room, the free space of the whole buffer is shared out again: half of it goes to the
+// stack that is full and the other half is split equally between all stacks, and the
+// regions are shifted in place to the new layout. The buffer doubles when less than a
+// quarter of it would be free. Each stack then has at least size() / (8 * NumStacks)
+// free slots after a repack, so push is amortized O(NumStacks).
+template<typename T, size_t NumStacks>
+class MultiStack {
+public:
+    static_assert(NumStacks > 0, "MultiStack needs at least one stack");
+
+    explicit MultiStack(size_t initialCapacity = 16 * NumStacks) : buffer(nullptr), bufferCapacity(0),
+                                                                   totalSize(0) {
+        bufferCapacity = std::max<size_t>(initialCapacity, 4);
+        buffer = static_cast<T *>(::operator new(bufferCapacity * sizeof(T)));
+        size_t share = bufferCapacity / NumStacks;
+        for (size_t i = 0; i < NumStacks; ++i)
+            stacks[i] = Region{i * share, 0, share};
+        stacks[NumStacks - 1].capacity = bufferCapacity - (NumStacks - 1) * share;
+    }
+
+    MultiStack(const MultiStack &) = delete;
+
+    MultiStack &operator=(const MultiStack &) = delete;
+
+    ~MultiStack() {
+        for (auto &stack : stacks) {
+            for (size_t i = 0; i < stack.size; ++i)
+                buffer[stack.start + i].~T();
+        }
+        ::operator delete(buffer);
+    }
+
+    template<typename U>
+    void push(size_t stackNum, U &&value) {
+        Region &stack = stacks[stackNum];
+        if (stack.size == stack.capacity)
+            makeRoom(stackNum);
+        new(buffer + stack.start + stack.size) T(std::forward<U>(value));
+        ++stack.size;
+        ++totalSize;
+    }
+
+    T &peek(size_t stackNum) {
+        Region &stack = stacks[stackNum];
+        if (stack.size == 0)
+            throw StackIsEmptyException();
+        return buffer[stack.start + stack.size - 1];
+    }
+
+    T pop(size_t stackNum) {
+        Region &stack = stacks[stackNum];
+        if (stack.size == 0)
+            throw StackIsEmptyException();
+        T *top = buffer + stack.start + stack.size - 1;
+        auto value(std::move(*top));
+        top->~T();
+        --stack.size;
+        --totalSize;
+        return value;
+    }
+
+    bool isEmpty(size_t stackNum) const {
+        return stacks[stackNum].size == 0;
+    }
+
+    size_t size(size_t stackNum) const {
+        return stacks[stackNum].size;
+    }
+
+    // Number of elements in all stacks
+    size_t size() const {
+        return totalSize;
+    }
+
+    size_t capacity() const {
+        return bufferCapacity;
+    }
+
+    class StackIsEmptyException {
+    };
+
+private:
+    struct Region {
+        size_t start;
+        size_t size;
+        size_t capacity;
+    };
+
+    void makeRoom(size_t fullStack) {
+        size_t newCapacity = bufferCapacity;
+        if (4 * (totalSize + 1) > 3 * bufferCapacity)
+            newCapacity = 2 * bufferCapacity;
+
+        size_t free = newCapacity - totalSize;
+        size_t equalShare = free / 2 / NumStacks;
+        size_t newStart[NumStacks];
+        size_t start = 0;
+        for (size_t i = 0; i < NumStacks; ++i) {
+            newStart[i] = start;
+            stacks[i].capacity = stacks[i].size + equalShare;
+            start += stacks[i].capacity;
+        }
+        // the full stack also takes the rounding remainder, so the regions fill the buffer
+        size_t extra = newCapacity - start;
+        stacks[fullStack].capacity += extra;
+        for (size_t i = fullStack + 1; i < NumStacks; ++i)
+            newStart[i] += extra;
+
+        if (newCapacity == bufferCapacity) {
+            shiftRegions(newStart);
+            return;
+        }
+        T *newBuffer = static_cast<T *>(::operator new(newCapacity * sizeof(T)));
+        for (size_t i = 0; i < NumStacks; ++i) {
+            relocate(buffer + stacks[i].start, newBuffer + newStart[i], stacks[i].size,
+                     std::is_trivially_copyable<T>());
+            stacks[i].start = newStart[i];
+        }
+        ::operator delete(buffer);
+        buffer = newBuffer;
+        bufferCapacity = newCapacity;
+    }
+
+    // Regions moving left are moved first, from left to right, then regions moving right,
+    // from right to left. A region is then never written over before it has been moved.
+    void shiftRegions(const size_t *newStart) {
+        for (size_t i = 0; i < NumStacks; ++i) {
+            if (newStart[i] < stacks[i].start)
+                shiftRegion(stacks[i], newStart[i]);
+        }
+        for (size_t i = NumStacks; i-- > 0;) {
+            if (newStart[i] > stacks[i].start)
+                shiftRegion(stacks[i], newStart[i]);
+        }
+    }
+
+    void shiftRegion(Region &stack, size_t newStart) {
+        relocate(buffer + stack.start, buffer + newStart, stack.size, std::is_trivially_copyable<T>());
+        stack.start = newStart;
+    }
+
+    // from and to may overlap
+    static void relocate(T *from, T *to, size_t n, std::true_type) {
+        if (n)
+            std::memmove(static_cast<void *>(to), from, n * sizeof(T));
+    }
+
+    static void relocate(T *from, T *to, size_t n, std::false_type) {
+        if (to < from) {
+            for (size_t i = 0; i < n; ++i) {
+                new(to + i) T(std::move(from[i]));
+                from[i].~T();
+            }
+        } else {
+            for (size_t i = n; i-- > 0;) {
+                new(to + i) T(std::move(from[i]));
+                from[i].~T();
+            }
+        }
+    }
+
+    T *buffer;
+    size_t bufferCapacity;
+    size_t totalSize;
+    Region stacks[NumStacks];
+};
+
+// Variant for stacks that are each used by their own thread. Regions are fixed, because
+// moving them would need every owner to stop, so push fails when a stack is full. Each
+// stack's header sits on its own cache line and each region starts on a cache line, so
+// one thread pushing does not invalidate the line another thread is using.
+template<typename T, size_t NumStacks, size_t HeaderAlignment = 64>
+class PerThreadMultiStack {
+public:
+    static constexpr size_t CacheLine = 64;
+
+    static_assert(NumStacks > 0, "PerThreadMultiStack needs at least one stack");
+    static_assert(CacheLine % alignof(T) == 0, "regions are aligned to cache lines");
+
+    explicit PerThreadMultiStack(size_t stackCapacity) {
+        size_t regionBytes = (stackCapacity * sizeof(T) + CacheLine - 1) / CacheLine * CacheLine;
+        allocation = ::operator new(NumStacks * regionBytes + CacheLine);
+        auto address = reinterpret_cast<std::uintptr_t>(allocation);
+        auto first = reinterpret_cast<unsigned char *>((address + CacheLine - 1) / CacheLine * CacheLine);
+        for (size_t i = 0; i < NumStacks; ++i) {
+            headers[i].base = reinterpret_cast<T *>(first + i * regionBytes);
+            headers[i].size = 0;
+            headers[i].capacity = stackCapacity;
+        }
+    }
+
+    PerThreadMultiStack(const PerThreadMultiStack &) = delete;
+
+    PerThreadMultiStack &operator=(const PerThreadMultiStack &) = delete;
+
+    ~PerThreadMultiStack() {
+        for (auto &header : headers) {
+            for (size_t i = 0; i < header.size; ++i)
+                header.base[i].~T();
+        }
+        ::operator delete(allocation);
+    }
+
+    // Returns false if the stack is full
+    template<typename U>
+    bool push(size_t stackNum, U &&value) {
+        Header &header = headers[stackNum];
+        if (header.size == header.capacity)
+            return false;
+        new(header.base + header.size) T(std::forward<U>(value));
+        ++header.size;
+        return true;
+    }
+
+    // Returns false if the stack is empty
+    bool pop(size_t stackNum, T &value) {
+        Header &header = headers[stackNum];
+        if (header.size == 0)
+            return false;
+        T *top = header.base + --header.size;
+        value = std::move(*top);
+        top->~T();
+        return true;
+    }
+
+    bool isEmpty(size_t stackNum) const {
+        return headers[stackNum].size == 0;
+    }
+
+    size_t size(size_t stackNum) const {
+        return headers[stackNum].size;
+    }
+
+private:
+    struct alignas(HeaderAlignment) Header {
+        T *base;
+        size_t size;
+        size_t capacity;
+    };
+
+    Header headers[NumStacks];
+    void *allocation;
+};
+
+// Stack numbers drawn with probability proportional to 1 / (i + 1)^skew
+template<size_t NumStacks>
+std::vector<unsigned char> skewedStackNumbers(size_t n, double skew) {
+    std::vector<double> weights(NumStacks);
+    for (size_t i = 0; i < NumStacks; ++i)
+        weights[i] = 1.0 / std::pow(i + 1.0, skew);
+    std::discrete_distribution<int> pick(weights.begin(), weights.end());
+    std::mt19937 mt(1);
+    std::vector<unsigned char> numbers(n);
+    for (auto &number : numbers)
+        number = static_cast<unsigned char>(pick(mt));
+    return numbers;
+}
+
+template<size_t NumStacks>
+void benchmarkSkew(size_t ops, double skew) {
+    std::vector<unsigned char> numbers = skewedStackNumbers<NumStacks>(ops, skew);
+    std::string skewName = " skew " + std::to_string(skew).substr(0, 3) + " fill then drain";
+
+    MultiStack<int, NumStacks> multi;
+    reportNsPerOp("MultiStack<" + std::to_string(NumStacks) + ">" + skewName, 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i)
+            multi.push(numbers[i], static_cast<int>(i));
+        for (size_t i = ops; i-- > 0;)
+            consume(multi.pop(numbers[i]));
+    }));
+
+    std::vector<int> vectors[NumStacks];
+    reportNsPerOp("std::vector[" + std::to_string(NumStacks) + "]" + skewName, 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i)
+            vectors[numbers[i]].push_back(static_cast<int>(i));
+        for (size_t i = ops; i-- > 0;) {
+            consume(vectors[numbers[i]].back());
+            vectors[numbers[i]].pop_back();
+        }
+    }));
+}
+
+// The hot stack moves to the next stack every burst, so capacity keeps being handed from
+// one region to another without the buffer growing.
+template<size_t NumStacks>
+void benchmarkRotatingHotStack(size_t ops, size_t burst) {
+    MultiStack<int, NumStacks> multi;
+    for (size_t i = 0; i < NumStacks; ++i)
+        multi.push(i, 0);
+    size_t rounds = std::max<size_t>(1, ops / (2 * burst));
+    std::string name = "MultiStack<" + std::to_string(NumStacks) + "> rotating burst of " + std::to_string(burst);
+    reportNsPerOp(name, 2 * rounds * burst, timeNs([&] {
+        for (size_t round = 0; round < rounds; ++round) {
+            size_t stack = round % NumStacks;
+            for (size_t i = 0; i < burst; ++i)
+                multi.push(stack, static_cast<int>(i));
+            for (size_t i = 0; i < burst; ++i)
+                consume(multi.pop(stack));
+        }
+    }));
+}
+
+// One thread per stack, each pushing and popping on its own stack
+template<size_t HeaderAlignment>
+void benchmarkPerThread(size_t ops, unsigned threads) {
+    const size_t NumStacks = 8;
+    PerThreadMultiStack<int, NumStacks, HeaderAlignment> multi(1024);
+    std::vector<std::thread> workers;
+    double ns = timeNs([&] {
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                int value = 0;
+                for (size_t i = 0; i < ops; ++i) {
+                    multi.push(t, static_cast<int>(i));
+                    if (i % 4 == 3) {
+                        for (int k = 0; k < 4; ++k)
+                            multi.pop(t, value);
+                    }
+                }
+                consume(value);
+            });
+        }
+        for (auto &worker : workers)
+            worker.join();
+    });
+    reportNsPerOp("PerThreadMultiStack align " + std::to_string(HeaderAlignment) + ", "
+                  + std::to_string(threads) + " threads", 2 * ops * threads, ns);
+}
+
+void benchmark(size_t ops) {
+    for (double skew : {0.0, 1.0, 2.0, 8.0}) {
+        benchmarkSkew<3>(ops, skew);
+        benchmarkSkew<16>(ops, skew);
+    }
+    benchmarkRotatingHotStack<3>(ops, 1000);
+    benchmarkRotatingHotStack<16>(ops, 1000);
+    benchmarkRotatingHotStack<16>(ops, 100000);
+    for (unsigned threads : {2u, 4u, 8u}) {
+        benchmarkPerThread<64>(ops, threads);
+        benchmarkPerThread<8>(ops, threads);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (size_t ops = benchmarkOps(argc, argv, 10000000)) {
+        benchmark(ops);
+        return 0;
+    }
+
+    // Every stack starts with room for 4 values, stack 0 takes the room of the others
+    MultiStack<int, 3> stacks(12);
+    for (int i = 0; i < 10; ++i)
+        stacks.push(0, i);
+    stacks.push(1, 100);
+    stacks.push(2, 200);
+    std::cout << "capacity " << stacks.capacity() << ", sizes " << stacks.size(0) << " "
+              << stacks.size(1) << " " << stacks.size(2) << std::endl;
+
+    for (size_t stackNum = 0; stackNum < 3; ++stackNum) {
+        std::cout << "Stack " << stackNum << ":";
+        while (!stacks.isEmpty(stackNum))
+            std::cout << " " << stacks.pop(stackNum);
+        std::cout << std::endl;
+    }
+
+    try {
+        stacks.pop(1);
+    } catch (MultiStack<int, 3>::StackIsEmptyException &) {
+        std::cout << "Stack 1 is empty." << std::endl;
+    }
+    return 0;
+}
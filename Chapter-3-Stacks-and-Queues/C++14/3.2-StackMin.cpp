@@ -2,6 +2,8 @@
 // which returns the minimum element? Push, pop and min should all operate in O(1) time.
 
 #include <iostream>
+#include <random>
+#include "benchmark.hpp"
 #include "stack.hpp"
 
 template<typename T>
@@ -38,7 +40,35 @@ private:
     Stack<T> minStack;
 };
 
-int main() {
+// Push/pop storms: fill then drain, and a push/pop sawtooth across a chunk boundary of the
+// underlying Stack.
+void benchmark(size_t ops) {
+    std::mt19937 mt(1);
+    StackMin<int> stack;
+    reportNsPerOp("StackMin fill then drain", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i)
+            stack.push(static_cast<int>(mt()));
+        for (size_t i = 0; i < ops; ++i)
+            consume(stack.pop());
+    }));
+
+    for (int i = 0; i < 4096; ++i)
+        stack.push(i);
+    reportNsPerOp("StackMin sawtooth at chunk boundary", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i) {
+            stack.push(static_cast<int>(i));
+            consume(stack.min());
+            consume(stack.pop());
+        }
+    }));
+}
+
+int main(int argc, char **argv) {
+    if (size_t ops = benchmarkOps(argc, argv, 10000000)) {
+        benchmark(ops);
+        return 0;
+    }
+
     StackMin<int> stack;
     for (auto v : {5, 10, 4, 9, 3, 3, 8, 2, 2, 7, 6}) {
         stack.push(v);
@@ -6,6 +6,7 @@
 // (that is, pop() should return the same values as it would if there just a single stack).
 
 #include <iostream>
+#include "benchmark.hpp"
 #include "stack.hpp"
 
 template<typename T, size_t Capacity>
@@ -14,7 +15,7 @@ public:
     template<typename U>
     void push(U &&value) {
         if (stacks.isEmpty() || stacks.peek().size() >= Capacity)
-            stacks.push(Stack<T>()); // start new stack
+            stacks.push(SubStack()); // start new stack
         stacks.peek().push(std::forward<U>(value));
     }
 
@@ -35,7 +36,10 @@ public:
     }
 
 private:
-    Stack<Stack<T>> stacks;
+    // A sub-stack never holds more than Capacity values, so its chunks need not be larger
+    using SubStack = Stack<T, (Capacity < 1024 ? Capacity : 1024)>;
+
+    Stack<SubStack> stacks;
 };
 
 // If Capacity is 1 we do not need stack of stacks.
@@ -50,7 +54,40 @@ public:
     SetOfStacks() = delete;
 };
 
-int main() {
+template<size_t Capacity>
+void benchmarkCapacity(size_t ops) {
+    SetOfStacks<int, Capacity> stack;
+    std::string name = "SetOfStacks<" + std::to_string(Capacity) + "> ";
+    reportNsPerOp(name + "fill then drain", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i)
+            stack.push(static_cast<int>(i));
+        for (size_t i = 0; i < ops; ++i)
+            consume(stack.pop());
+    }));
+
+    // sawtooth across a sub-stack boundary: every push starts a new sub-stack
+    for (size_t i = 0; i < Capacity; ++i)
+        stack.push(static_cast<int>(i));
+    reportNsPerOp(name + "sawtooth at sub-stack boundary", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i) {
+            stack.push(static_cast<int>(i));
+            consume(stack.pop());
+        }
+    }));
+}
+
+// Push/pop storms for small and large sub-stacks
+void benchmark(size_t ops) {
+    benchmarkCapacity<16>(ops);
+    benchmarkCapacity<1024>(ops);
+}
+
+int main(int argc, char **argv) {
+    if (size_t ops = benchmarkOps(argc, argv, 10000000)) {
+        benchmark(ops);
+        return 0;
+    }
+
     SetOfStacks<int, 2> stack;
 
     for (int i = 0; i < 11; ++i) {
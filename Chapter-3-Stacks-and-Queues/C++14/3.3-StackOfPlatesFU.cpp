@@ -4,91 +4,195 @@
 
 #include <iostream>
 #include <deque>
+#include <random>
+#include <vector>
+#include "benchmark.hpp"
 
+// Because popAt shifts the later values left, every sub-stack but the last is always full
+// and the set of stacks is one sequence of values cut every Capacity values. popAt(index)
+// is then erasing the value at position (index + 1) * Capacity - 1 of the sequence.
+//
+// The sequence is stored in chunks of up to ChunkSize values, with a Fenwick tree over the
+// chunk sizes to find the chunk holding a position in O(log n). Erasing only shifts values
+// inside one chunk, so chunks may be left part full; when there are more than twice as many
+// chunks as the values need, all chunks are packed again. push, pop and popAt are
+// O(log n), amortized for push and popAt.
 template<typename T, size_t Capacity>
 class SetOfStacks {
 public:
+    SetOfStacks() : count(0) {
+    }
+
     template<typename U>
     void push(U &&value) {
-        if (stacks.empty() || stacks.back().size() >= Capacity)
-            stacks.emplace_back(1, std::forward<U>(value));
-        else
-            stacks.back().push_back(std::forward<U>(value));
+        if (chunks.empty() || chunks.back().size() == ChunkSize)
+            appendChunk();
+        chunks.back().push_back(std::forward<U>(value));
+        addToSize(chunks.size() - 1, 1);
+        ++count;
     }
 
     T &peek() {
-        return stacks.back().back();
+        if (count == 0)
+            throw StackIsEmptyException();
+        return chunks.back().back();
     }
 
     T pop() {
-        T value = stacks.back().back();
-        stacks.back().pop_back();
-        if (stacks.back().empty())
-            stacks.pop_back();
+        if (count == 0)
+            throw StackIsEmptyException();
+        T value = std::move(chunks.back().back());
+        chunks.back().pop_back();
+        addToSize(chunks.size() - 1, -1);
+        --count;
+        dropEmptyChunksAtEnd();
         return value;
     }
 
-    // O(N)
+    // O(log n) amortized
     T popAt(int index) {
-        if (index < 0 || index >= stacks.size())
+        if (index < 0 || static_cast<size_t>(index) >= size())
             throw OutOfIndexException();
-        T value = stacks[index].back();
-        stacks[index].pop_back();
-        shiftLeftTo(index);
+        size_t position = std::min((index + 1) * Capacity, count) - 1;
+        size_t offset;
+        size_t chunk = findChunk(position, offset);
+        T value = std::move(chunks[chunk][offset]);
+        chunks[chunk].erase(chunks[chunk].begin() + offset);
+        addToSize(chunk, -1);
+        --count;
+        dropEmptyChunksAtEnd();
+        if (chunks.size() > 2 * (count / ChunkSize) + 2)
+            compact();
         return value;
     }
 
     // Number of used limited stacks
     size_t size() const {
-        return stacks.size();
+        return (count + Capacity - 1) / Capacity;
     }
 
     class OutOfIndexException {
     };
 
+    class StackIsEmptyException {
+    };
 
 private:
+    static const size_t ChunkSize = 64;
 
-    void shiftLeftTo(int index) {
-        if (index == stacks.size() - 1) {
-            // last stack
-            if (stacks.back().empty())
-                stacks.pop_back();
-        } else {
-            stacks[index].push_back(stacks[index + 1].front());
-            stacks[index + 1].pop_front();
-            shiftLeftTo(index + 1);
+    void appendChunk() {
+        chunks.emplace_back();
+        chunks.back().reserve(ChunkSize);
+        // a new Fenwick node covers the chunks (i - lowbit(i), i], all already counted
+        size_t i = chunks.size();
+        size_t lowest = i & (~i + 1);
+        sizes.push_back(prefixSize(i - 1) - prefixSize(i - lowest));
+    }
+
+    void dropEmptyChunksAtEnd() {
+        // a Fenwick node only covers chunks before it, so dropping the last node is enough
+        while (!chunks.empty() && chunks.back().empty()) {
+            chunks.pop_back();
+            sizes.pop_back();
         }
     }
 
-    std::deque<std::deque<T>> stacks;
+    // Fenwick tree over chunk sizes, sizes[i - 1] covers the chunks (i - lowbit(i), i]
+    void addToSize(size_t chunk, int delta) {
+        for (size_t i = chunk + 1; i <= sizes.size(); i += i & (~i + 1))
+            sizes[i - 1] += delta;
+    }
+
+    // Number of values in the first n chunks
+    size_t prefixSize(size_t n) const {
+        size_t sum = 0;
+        for (size_t i = n; i > 0; i -= i & (~i + 1))
+            sum += sizes[i - 1];
+        return sum;
+    }
+
+    // Chunk holding the value at position, and the value's offset in that chunk
+    size_t findChunk(size_t position, size_t &offset) const {
+        size_t chunk = 0;
+        size_t step = 1;
+        while (2 * step <= sizes.size())
+            step *= 2;
+        for (; step > 0; step /= 2) {
+            if (chunk + step <= sizes.size() && sizes[chunk + step - 1] <= position) {
+                chunk += step;
+                position -= sizes[chunk - 1];
+            }
+        }
+        offset = position;
+        return chunk;
+    }
+
+    // Packs all values into full chunks and rebuilds the Fenwick tree in O(n)
+    void compact() {
+        std::vector<std::vector<T>> packed;
+        for (auto &chunk : chunks) {
+            for (auto &value : chunk) {
+                if (packed.empty() || packed.back().size() == ChunkSize) {
+                    packed.emplace_back();
+                    packed.back().reserve(ChunkSize);
+                }
+                packed.back().push_back(std::move(value));
+            }
+        }
+        chunks.swap(packed);
+        sizes.assign(chunks.size(), 0);
+        for (size_t i = 1; i <= chunks.size(); ++i) {
+            sizes[i - 1] += chunks[i - 1].size();
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= chunks.size())
+                sizes[parent - 1] += sizes[i - 1];
+        }
+    }
+
+    std::vector<std::vector<T>> chunks;
+    std::vector<size_t> sizes;
+    size_t count;
 };
 
-// Special case if capacity is 1. In this case popAt(int index) makes a specified sub-stack empty,
-// it should be then removed instead of shifting left values.
+// Forbid capacity 0
 template<typename T>
-class SetOfStacks<T, 1> {
+class SetOfStacks<T, 0> {
+public:
+    SetOfStacks() = delete;
+};
+
+// The previous popAt, which moves one value through every later sub-stack. It is kept as
+// the baseline for the benchmark, with the shift as a loop so 10^6 sub-stacks do not
+// overflow the call stack.
+template<typename T, size_t Capacity>
+class CascadingSetOfStacks {
 public:
     template<typename U>
     void push(U &&value) {
-        stacks.push_back(std::forward<T>(value));
-    }
-
-    T &peek() {
-        return stacks.at(stacks.size() - 1);
+        if (stacks.empty() || stacks.back().size() >= Capacity)
+            stacks.emplace_back(1, std::forward<U>(value));
+        else
+            stacks.back().push_back(std::forward<U>(value));
     }
 
     T pop() {
-        T value = stacks.back();
-        stacks.pop_back();
+        T value = stacks.back().back();
+        stacks.back().pop_back();
+        if (stacks.back().empty())
+            stacks.pop_back();
         return value;
     }
 
+    // O(N)
     T popAt(int index) {
-        if (index < 0 || index >= stacks.size())
-            throw OutOfIndexException();
-        T value = stacks.at(index);
-        stacks.erase(stacks.begin() + index);
+        T value = stacks[index].back();
+        stacks[index].pop_back();
+        for (size_t i = index; i + 1 < stacks.size(); ++i) {
+            stacks[i].push_back(stacks[i + 1].front());
+            stacks[i + 1].pop_front();
+        }
+        if (stacks.back().empty())
+            stacks.pop_back();
         return value;
     }
 
@@ -96,36 +200,45 @@ public:
         return stacks.size();
     }
 
-    class OutOfIndexException {
-    };
-
-
 private:
+    std::deque<std::deque<T>> stacks;
+};
 
-    void shiftLeftTo(int index) {
-        if (index == stacks.size() - 1) {
-            // last stack
-            if (stacks.back().empty())
-                stacks.pop_back();
-        } else {
-            stacks[index].push_back(stacks[index + 1].front());
-            stacks[index + 1].pop_front();
-            shiftLeftTo(index + 1);
-        }
-    }
+template<typename Stacks>
+void benchmarkStacks(const std::string &name, size_t subStacks, size_t popAts) {
+    const size_t Capacity = 4;
+    Stacks stacks;
+    reportNsPerOp(name + " push", subStacks * Capacity, timeNs([&] {
+        for (size_t i = 0; i < subStacks * Capacity; ++i)
+            stacks.push(static_cast<int>(i));
+    }));
 
-    std::deque<T> stacks;
-};
+    std::mt19937 mt(1);
+    reportNsPerOp(name + " popAt random sub-stack", popAts, timeNs([&] {
+        for (size_t i = 0; i < popAts; ++i)
+            consume(stacks.popAt(static_cast<int>(mt() % stacks.size())));
+    }));
+
+    size_t remaining = subStacks * Capacity - popAts;
+    reportNsPerOp(name + " pop", remaining, timeNs([&] {
+        for (size_t i = 0; i < remaining; ++i)
+            consume(stacks.pop());
+    }));
+}
 
+// 10^6 sub-stacks of 4 values by default. The cascading version only gets a few popAt
+// calls, each of which touches every later sub-stack.
+void benchmark(size_t subStacks) {
+    benchmarkStacks<SetOfStacks<int, 4>>("SetOfStacks", subStacks, subStacks);
+    benchmarkStacks<CascadingSetOfStacks<int, 4>>("CascadingSetOfStacks", subStacks, 100);
+}
 
-// Forbid capacity 0
-template<typename T>
-class SetOfStacks<T, 0> {
-public:
-    SetOfStacks() = delete;
-};
+int main(int argc, char **argv) {
+    if (size_t subStacks = benchmarkOps(argc, argv, 1000000)) {
+        benchmark(subStacks);
+        return 0;
+    }
 
-int main() {
     SetOfStacks<int, 2> stack;
     for (int i = 0; i < 13; ++i) {
         stack.push(i);
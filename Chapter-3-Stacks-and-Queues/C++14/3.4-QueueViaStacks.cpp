@@ -1,6 +1,9 @@
 // Queue via Stacks: Implement a MyQueue class which implements a queue using two stacks.
 
+#include <chrono>
 #include <iostream>
+#include <vector>
+#include "benchmark.hpp"
 #include "stack.hpp"
 
 template<typename T>
@@ -37,7 +40,215 @@ private:
     Stack<T> reversed;
 };
 
-int main() {
+// Queue via stacks where add and remove are O(1) in the worst case, after Hood and
+// Melville's real-time queue. MyQueue reverses all new values at once when its front runs
+// dry. Here a new front is built as soon as back holds more values than front, a few steps
+// on every operation, while front keeps serving removes:
+//   1. empty nextFront, which still holds the front before the last rebuild
+//   2. copy front onto frontCopy, reading it from the top down with a cursor
+//   3. move back onto nextFront
+//   4. move frontCopy onto nextFront
+//   5. pop the copied values that were removed from front meanwhile off nextFront
+// Then nextFront becomes front. Values added during the rebuild go to nextBack. For a
+// front of n values a rebuild takes at most 4n + 1 steps plus one per remove, so with
+// StepsPerOperation = 5 it ends before front runs out. Values of front are copied once,
+// so T must be copyable.
+template<typename T>
+class RealTimeQueue {
+public:
+    RealTimeQueue() : front(&stacks[0]), back(&stacks[1]), nextBack(&stacks[2]), frontCopy(&stacks[3]),
+                      nextFront(&stacks[4]), phase(Idle), cursor(stacks[0].fromTop()), removed(0),
+                      queueSize(0) {
+    }
+
+    RealTimeQueue(const RealTimeQueue &) = delete;
+
+    RealTimeQueue &operator=(const RealTimeQueue &) = delete;
+
+    template<typename U>
+    void add(U &&value) {
+        step();
+        if (phase == Idle)
+            back->push(std::forward<U>(value));
+        else
+            nextBack->push(std::forward<U>(value));
+        ++queueSize;
+        startRebuildIfNeeded();
+    }
+
+    T &peek() {
+        step();
+        return front->peek();
+    }
+
+    T remove() {
+        step();
+        if (phase == EmptyNextFront || phase == CopyFront) {
+            // the cursor must not be left on the popped value
+            if (!cursor.done() && &cursor.value() == &front->peek())
+                cursor.next();
+            else
+                ++removed;
+        } else if (phase != Idle) {
+            ++removed;
+        }
+        T value = front->pop();
+        --queueSize;
+        startRebuildIfNeeded();
+        return value;
+    }
+
+    bool isEmpty() const {
+        return queueSize == 0;
+    }
+
+    size_t size() const {
+        return queueSize;
+    }
+
+private:
+    static const int StepsPerOperation = 5;
+
+    enum Phase {
+        Idle, EmptyNextFront, CopyFront, MoveBack, MoveFrontCopy, DropRemoved
+    };
+
+    void startRebuildIfNeeded() {
+        if (phase != Idle || back->size() <= front->size())
+            return;
+        phase = EmptyNextFront;
+        cursor = front->fromTop();
+        removed = 0;
+        step();
+    }
+
+    void step() {
+        for (int steps = 0; steps < StepsPerOperation; ++steps) {
+            switch (phase) {
+                case Idle:
+                    // empty the old front between rebuilds too
+                    if (nextFront->isEmpty())
+                        return;
+                    nextFront->pop();
+                    break;
+                case EmptyNextFront:
+                    if (nextFront->isEmpty())
+                        phase = CopyFront;
+                    else
+                        nextFront->pop();
+                    break;
+                case CopyFront:
+                    if (cursor.done()) {
+                        phase = MoveBack;
+                    } else {
+                        frontCopy->push(cursor.value());
+                        cursor.next();
+                    }
+                    break;
+                case MoveBack:
+                    if (back->isEmpty())
+                        phase = MoveFrontCopy;
+                    else
+                        nextFront->push(back->pop());
+                    break;
+                case MoveFrontCopy:
+                    if (frontCopy->isEmpty())
+                        phase = DropRemoved;
+                    else
+                        nextFront->push(frontCopy->pop());
+                    break;
+                case DropRemoved:
+                    if (removed == 0) {
+                        finishRebuild();
+                        return;
+                    }
+                    nextFront->pop();
+                    --removed;
+                    break;
+            }
+        }
+    }
+
+    // The old front still holds the values that were not removed, it is emptied a few
+    // values per operation as the next nextFront
+    void finishRebuild() {
+        std::swap(front, nextFront);
+        std::swap(back, nextBack);
+        phase = Idle;
+    }
+
+    Stack<T> stacks[5];
+    Stack<T> *front;       // oldest value on top
+    Stack<T> *back;        // newest value on top
+    Stack<T> *nextBack;    // values added during a rebuild
+    Stack<T> *frontCopy;
+    Stack<T> *nextFront;
+    Phase phase;
+    typename Stack<T>::Cursor cursor;
+    size_t removed;        // copied values removed from front since the rebuild started
+    size_t queueSize;
+};
+
+// Add/remove storms: fill then drain (one big transfer) and a steady state queue of
+// fixed depth (many small transfers).
+template<typename Queue>
+void benchmarkThroughput(const std::string &name, size_t ops) {
+    Queue queue;
+    reportNsPerOp(name + " fill then drain", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i)
+            queue.add(static_cast<int>(i));
+        for (size_t i = 0; i < ops; ++i)
+            consume(queue.remove());
+    }));
+
+    for (int i = 0; i < 1000; ++i)
+        queue.add(i);
+    reportNsPerOp(name + " steady state, depth 1000", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i) {
+            queue.add(static_cast<int>(i));
+            consume(queue.remove());
+        }
+    }));
+}
+
+// Latency of every single add and remove on a queue of fixed depth. MyQueue's transfers
+// show up as a tail proportional to the depth.
+template<typename Queue>
+void benchmarkLatency(const std::string &name, size_t ops, size_t depth) {
+    Queue queue;
+    for (size_t i = 0; i < depth; ++i)
+        queue.add(static_cast<int>(i));
+    std::vector<double> samples;
+    samples.reserve(2 * ops);
+    for (size_t i = 0; i < ops; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        queue.add(static_cast<int>(i));
+        auto added = std::chrono::steady_clock::now();
+        consume(queue.remove());
+        auto removed = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(added - start).count());
+        samples.push_back(std::chrono::duration<double, std::nano>(removed - added).count());
+    }
+    std::string label = name + " latency, depth " + std::to_string(depth);
+    reportPercentiles(label, samples);
+    reportHistogram(label, samples);
+}
+
+void benchmark(size_t ops) {
+    benchmarkThroughput<MyQueue<int>>("MyQueue", ops);
+    benchmarkThroughput<RealTimeQueue<int>>("RealTimeQueue", ops);
+    for (size_t depth : {1000, 1000000}) {
+        benchmarkLatency<MyQueue<int>>("MyQueue", ops, depth);
+        benchmarkLatency<RealTimeQueue<int>>("RealTimeQueue", ops, depth);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (size_t ops = benchmarkOps(argc, argv, 10000000)) {
+        benchmark(ops);
+        return 0;
+    }
+
     MyQueue<int> queue;
     for (int i = 0; i < 10; ++i) {
         queue.add(i);
@@ -2,7 +2,14 @@
 // an additonal temporary stack, but you may not copy the elements into any other data struture
 // (such as an array). The stack support the following operations: pop, peek, and isEmpty.
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+#include "benchmark.hpp"
+#include "daryheap.hpp"
 #include "stack.hpp"
 
 template<typename T>
@@ -58,7 +65,150 @@ private:
     bool sorted;
 };
 
-int main() {
+// Same API as SortedStack for values pushed in bursts. Pushes are appended unsorted; the
+// first peek or pop afterwards sorts a large batch once in O(k log k) and merges it into
+// a run kept in descending order, so the smallest value is popped off its back in O(1).
+// A batch that is small next to the run is pushed onto a d-ary heap instead, so
+// interleaved push/pop costs O(log n) rather than a merge of the whole run.
+template<typename T, size_t Arity = 4>
+class BurstSortedStack {
+public:
+    template<typename U>
+    void push(U &&value) {
+        pending.push_back(std::forward<U>(value));
+    }
+
+    const T &peek() {
+        settle();
+        if (fromRun())
+            return run.back();
+        return heap.peek();
+    }
+
+    T pop() {
+        settle();
+        if (fromRun()) {
+            T value = std::move(run.back());
+            run.pop_back();
+            return value;
+        }
+        return heap.pop();
+    }
+
+    bool isEmpty() const {
+        return pending.empty() && run.empty() && heap.isEmpty();
+    }
+
+    size_t size() const {
+        return pending.size() + run.size() + heap.size();
+    }
+
+    class StackIsEmptyException {
+    };
+
+private:
+    // A batch at least this fraction of the run is sorted and merged
+    static const size_t MergeRatio = 8;
+
+    void settle() {
+        if (pending.empty()) {
+            if (run.empty() && heap.isEmpty())
+                throw StackIsEmptyException();
+            return;
+        }
+        if (pending.size() * MergeRatio < run.size() + heap.size()) {
+            for (auto &value : pending)
+                heap.push(std::move(value));
+        } else {
+            std::sort(pending.begin(), pending.end(), std::greater<T>());
+            size_t middle = run.size();
+            run.insert(run.end(), std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
+            std::inplace_merge(run.begin(), run.begin() + middle, run.end(), std::greater<T>());
+        }
+        pending.clear();
+    }
+
+    bool fromRun() const {
+        return !run.empty() && (heap.isEmpty() || !(heap.peek() < run.back()));
+    }
+
+    std::vector<T> pending;   // pushed since the last peek or pop
+    std::vector<T> run;       // descending, smallest at the back
+    DaryHeap<T, Arity> heap;
+};
+
+// Push all then pop all, one value in and one out at a fixed depth, and bursts of pushes
+// followed by half as many pops.
+template<typename Sorted>
+void benchmarkStack(const std::string &name, size_t n) {
+    std::mt19937 mt(1);
+    Sorted stack;
+    reportNsPerOp(name + " push all, pop all", 2 * n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i)
+            stack.push(static_cast<int>(mt()));
+        while (!stack.isEmpty())
+            consume(stack.pop());
+    }));
+
+    for (size_t i = 0; i < n; ++i)
+        stack.push(static_cast<int>(mt()));
+    reportNsPerOp(name + " interleaved, depth " + std::to_string(n), 2 * n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i) {
+            stack.push(static_cast<int>(mt()));
+            consume(stack.pop());
+        }
+    }));
+    while (!stack.isEmpty())
+        stack.pop();
+
+    const size_t burst = std::max<size_t>(2, n / 100);
+    reportNsPerOp(name + " bursts of " + std::to_string(burst), 3 * n / 2, timeNs([&] {
+        for (size_t pushed = 0; pushed < n; pushed += burst) {
+            for (size_t i = 0; i < burst; ++i)
+                stack.push(static_cast<int>(mt()));
+            for (size_t i = 0; i < burst / 2; ++i)
+                consume(stack.pop());
+        }
+    }));
+}
+
+// std::priority_queue with the push/peek/pop/isEmpty API, smallest on top
+class StdPriorityQueue {
+public:
+    void push(int value) {
+        queue.push(value);
+    }
+
+    int pop() {
+        int value = queue.top();
+        queue.pop();
+        return value;
+    }
+
+    bool isEmpty() const {
+        return queue.empty();
+    }
+
+private:
+    std::priority_queue<int, std::vector<int>, std::greater<int>> queue;
+};
+
+// 10^6 values by default. SortedStack::sort() is O(n^2), so it only gets 10^4.
+void benchmark(size_t n) {
+    benchmarkStack<SortedStack<int>>("SortedStack", std::min<size_t>(n, 10000));
+    benchmarkStack<DaryHeap<int, 2>>("DaryHeap<2>", n);
+    benchmarkStack<DaryHeap<int, 4>>("DaryHeap<4>", n);
+    benchmarkStack<DaryHeap<int, 8>>("DaryHeap<8>", n);
+    benchmarkStack<BurstSortedStack<int>>("BurstSortedStack", n);
+    benchmarkStack<StdPriorityQueue>("std::priority_queue", n);
+}
+
+int main(int argc, char **argv) {
+    if (size_t ops = benchmarkOps(argc, argv, 1000000)) {
+        benchmark(ops);
+        return 0;
+    }
+
     SortedStack<int> stack;
     for (auto v : {5, 10, 4, 9, 3, 3, 8, 1, 2, 2, 7, 6}) {
         stack.push(v);
@@ -6,9 +6,14 @@
 // and dequeueCat. You may use the built-in LinkedList data structure.
 
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <random>
+#include <vector>
+#include "benchmark.hpp"
 #include "queue.hpp"
+#include "typedfifo.hpp"
 
 class Animal {
 protected:
@@ -58,9 +63,51 @@ public:
     }
 };
 
+// The animal kind is a plain enum, so the shelter dispatches on it without RTTI and keeps
+// the animals by value in one ring buffer per kind. More kinds only need more enumerators.
+enum class AnimalKind {
+    Dog,
+    Cat,
+    Count
+};
+
+struct ShelterAnimal {
+    AnimalKind kind;
+    std::string name;
+};
+
 class Shelter {
 public:
-    Shelter() : nextOrderNo(0) {
+    void enqueue(AnimalKind kind, std::string &&name) {
+        animals.enqueue(kind, std::move(name));
+    }
+
+    ShelterAnimal dequeueAny() {
+        AnimalKind kind = animals.peekAnyCategory();
+        return ShelterAnimal{kind, animals.dequeueAny()};
+    }
+
+    ShelterAnimal dequeueDog() {
+        return ShelterAnimal{AnimalKind::Dog, animals.dequeue(AnimalKind::Dog)};
+    }
+
+    ShelterAnimal dequeueCat() {
+        return ShelterAnimal{AnimalKind::Cat, animals.dequeue(AnimalKind::Cat)};
+    }
+
+    bool isEmpty() const {
+        return animals.isEmpty();
+    }
+
+private:
+    TypedFifo<AnimalKind, std::string> animals;
+};
+
+// The previous Shelter, which finds the kind of every animal with dynamic_pointer_cast and
+// keeps shared pointers in linked queues. It is kept as the baseline for the benchmark.
+class RttiShelter {
+public:
+    RttiShelter() : nextOrderNo(0) {
     }
 
     void enqueue(std::shared_ptr<Animal> &&animal) {
@@ -102,27 +149,121 @@ private:
     size_t nextOrderNo;
 };
 
-int main() {
+template<size_t Kinds>
+using Fifo = TypedFifo<size_t, std::string, Kinds>;
+
+std::vector<std::string> benchmarkNames(size_t n, size_t kinds, size_t runLength, std::vector<size_t> &kindOf) {
+    std::mt19937 mt(1);
+    std::vector<std::string> names;
+    kindOf.clear();
+    for (size_t i = 0; i < n; ++i) {
+        if (i % runLength == 0)
+            kindOf.push_back(mt() % kinds);
+        else
+            kindOf.push_back(kindOf.back());
+        names.push_back("Pet " + std::to_string(i));
+    }
+    return names;
+}
+
+void benchmarkRttiShelter(size_t n) {
+    std::vector<size_t> kindOf;
+    std::vector<std::string> names = benchmarkNames(n, 2, 1, kindOf);
+    RttiShelter shelter;
+    reportNsPerOp("RttiShelter enqueue", n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i) {
+            if (kindOf[i] == 0)
+                shelter.enqueue(Animal::create<Dog>(std::string(names[i])));
+            else
+                shelter.enqueue(Animal::create<Cat>(std::string(names[i])));
+        }
+    }));
+    reportNsPerOp("RttiShelter dequeueAny", n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i)
+            consume(shelter.dequeueAny()->getName().size());
+    }));
+}
+
+void benchmarkShelter(size_t n) {
+    std::vector<size_t> kindOf;
+    std::vector<std::string> names = benchmarkNames(n, 2, 1, kindOf);
+    Shelter shelter;
+    reportNsPerOp("Shelter enqueue", n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i)
+            shelter.enqueue(static_cast<AnimalKind>(kindOf[i]), std::string(names[i]));
+    }));
+    reportNsPerOp("Shelter dequeueAny", n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i)
+            consume(shelter.dequeueAny().name.size());
+    }));
+}
+
+// Kinds categories, each arrival starting a run of runLength values of one category.
+// dequeueAny is timed one value at a time and in batches of 64.
+template<size_t Kinds>
+void benchmarkTypedFifo(size_t n, size_t runLength) {
+    std::vector<size_t> kindOf;
+    std::vector<std::string> names = benchmarkNames(n, Kinds, runLength, kindOf);
+    std::string suffix = "<" + std::to_string(Kinds) + "> runs of " + std::to_string(runLength);
+    Fifo<Kinds> fifo;
+    auto fill = [&] {
+        for (size_t i = 0; i < n; ++i)
+            fifo.enqueue(kindOf[i], std::string(names[i]));
+    };
+
+    reportNsPerOp("TypedFifo" + suffix + " enqueue", n, timeNs(fill));
+    reportNsPerOp("TypedFifo" + suffix + " dequeueAny", n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i)
+            consume(fifo.dequeueAny().size());
+    }));
+
+    fill();
+    std::vector<std::string> batch;
+    reportNsPerOp("TypedFifo" + suffix + " dequeueAny_n(64)", n, timeNs([&] {
+        while (!fifo.isEmpty()) {
+            batch.clear();
+            fifo.dequeueAny_n(std::back_inserter(batch), 64);
+            consume(batch.back().size());
+        }
+    }));
+}
+
+// 10^6 animals by default
+void benchmark(size_t n) {
+    benchmarkRttiShelter(n);
+    benchmarkShelter(n);
+    benchmarkTypedFifo<2>(n, 1);
+    benchmarkTypedFifo<32>(n, 1);
+    benchmarkTypedFifo<32>(n, 16);
+    benchmarkTypedFifo<256>(n, 1);
+}
+
+int main(int argc, char **argv) {
+    if (size_t n = benchmarkOps(argc, argv, 1000000)) {
+        benchmark(n);
+        return 0;
+    }
+
     Shelter shelter;
     for (auto name : {"Dog 1", "Cat 1", "Dog 2", "Dog 3 ", "Cat 2", "Cat 3", "Cat 4", "Dog 4", "Dog 5", "Dog 6",
                       "Cat 5", "Cat 6", "Dog 7", "Dog 8", "Cat 7", "Dog 9"}) {
         if (name[0] == 'D')
-            shelter.enqueue(Animal::create<Dog>(std::move(name)));
+            shelter.enqueue(AnimalKind::Dog, name);
         else if (name[0] == 'C')
-            shelter.enqueue(Animal::create<Cat>(std::move(name)));
+            shelter.enqueue(AnimalKind::Cat, name);
     }
 
-    std::cout << "any --> " << shelter.dequeueAny()->getName() << std::endl;
-    std::cout << "any --> " << shelter.dequeueAny()->getName() << std::endl;
+    std::cout << "any --> " << shelter.dequeueAny().name << std::endl;
+    std::cout << "any --> " << shelter.dequeueAny().name << std::endl;
 
-    std::cout << "dog --> " << shelter.dequeueDog()->getName() << std::endl;
-    std::cout << "cat --> " << shelter.dequeueCat()->getName() << std::endl;
-    std::cout << "cat --> " << shelter.dequeueCat()->getName() << std::endl;
-    std::cout << "cat --> " << shelter.dequeueCat()->getName() << std::endl;
-    std::cout << "cat --> " << shelter.dequeueCat()->getName() << std::endl;
-    std::cout << "dog --> " << shelter.dequeueDog()->getName() << std::endl;
-    std::cout << "dog --> " << shelter.dequeueDog()->getName() << std::endl;
-    std::cout << "cat --> " << shelter.dequeueCat()->getName() << std::endl;
-    std::cout << "any --> " << shelter.dequeueAny()->getName() << std::endl;
+    std::cout << "dog --> " << shelter.dequeueDog().name << std::endl;
+    std::cout << "cat --> " << shelter.dequeueCat().name << std::endl;
+    std::cout << "cat --> " << shelter.dequeueCat().name << std::endl;
+    std::cout << "cat --> " << shelter.dequeueCat().name << std::endl;
+    std::cout << "cat --> " << shelter.dequeueCat().name << std::endl;
+    std::cout << "dog --> " << shelter.dequeueDog().name << std::endl;
+    std::cout << "dog --> " << shelter.dequeueDog().name << std::endl;
+    std::cout << "cat --> " << shelter.dequeueCat().name << std::endl;
+    std::cout << "any --> " << shelter.dequeueAny().name << std::endl;
     return 0;
-}
\ No newline at end of file
+}
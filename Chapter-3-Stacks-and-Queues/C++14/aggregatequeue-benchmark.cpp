@@ -0,0 +1,72 @@
+// Sliding window aggregates over a long stream: AggregateQueue for min, sum and gcd,
+// MonotonicAggregateQueue for min, and rescanning the window for small windows.
+//
+// Usage: aggregatequeue-benchmark --benchmark [stream length]   default 10^8
+
+#include <cstdint>
+#include <deque>
+#include "aggregatequeue.hpp"
+#include "benchmark.hpp"
+
+// Cheap generator, so the stream does not have to be stored
+struct Stream {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    int64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<int64_t>(state % 1000000);
+    }
+};
+
+template<typename Queue>
+void slide(const std::string &name, size_t length, size_t window) {
+    Queue queue;
+    Stream stream;
+    double ns = timeNs([&] {
+        for (size_t i = 0; i < length; ++i) {
+            queue.add(stream.next());
+            if (queue.size() > window)
+                queue.remove();
+            consume(queue.aggregate());
+        }
+    });
+    reportNsPerOp(name + ", window " + std::to_string(window), length, ns);
+}
+
+template<typename Monoid>
+void rescan(const std::string &name, size_t length, size_t window) {
+    std::deque<int64_t> values;
+    Stream stream;
+    double ns = timeNs([&] {
+        for (size_t i = 0; i < length; ++i) {
+            values.push_back(stream.next());
+            if (values.size() > window)
+                values.pop_front();
+            int64_t aggregate = Monoid::identity();
+            for (int64_t value : values)
+                aggregate = Monoid::combine(aggregate, value);
+            consume(aggregate);
+        }
+    });
+    reportNsPerOp(name + ", window " + std::to_string(window), length, ns);
+}
+
+int main(int argc, char **argv) {
+    size_t length = benchmarkOps(argc, argv, 100000000);
+    if (length == 0)
+        length = 100000000;
+
+    for (size_t window : {16, 1024, 65536, 4194304}) {
+        slide<MonotonicAggregateQueue<int64_t, MinMonoid<int64_t>>>("min, MonotonicAggregateQueue", length, window);
+        slide<AggregateQueue<int64_t, MinMonoid<int64_t>>>("min, AggregateQueue", length, window);
+        slide<AggregateQueue<int64_t, SumMonoid<int64_t>>>("sum, AggregateQueue", length, window);
+        slide<AggregateQueue<int64_t, GcdMonoid<int64_t>>>("gcd, AggregateQueue", length, window);
+        if (window <= 16) {
+            rescan<MinMonoid<int64_t>>("min, rescan", length, window);
+            rescan<SumMonoid<int64_t>>("sum, rescan", length, window);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+#include <deque>
+#include <random>
+#include <string>
+#include "aggregatequeue.hpp"
+
+class AggregateQueueTests : public ::testing::Test {
+public:
+    AggregateQueueTests() = default;
+};
+
+// Not commutative: the aggregate shows the order in which values were combined
+struct ConcatMonoid {
+    static std::string identity() {
+        return "";
+    }
+
+    static std::string combine(const std::string &a, const std::string &b) {
+        return a + b;
+    }
+};
+
+// Slides random windows over a random stream and compares the aggregate with a rescan of
+// the window, including windows that shrink to empty
+template<typename Queue, typename Monoid>
+void checkAgainstRescan(int maxValue) {
+    std::mt19937 mt(7);
+    Queue queue;
+    std::deque<long> window;
+    for (int i = 0; i < 20000; ++i) {
+        if (window.empty() || mt() % 100 < 52) {
+            long value = static_cast<long>(mt() % maxValue) - maxValue / 4;
+            queue.add(value);
+            window.push_back(value);
+        } else {
+            ASSERT_EQ(window.front(), queue.peek());
+            ASSERT_EQ(window.front(), queue.remove());
+            window.pop_front();
+        }
+        long expected = Monoid::identity();
+        for (long value : window)
+            expected = Monoid::combine(expected, value);
+        ASSERT_EQ(expected, queue.aggregate());
+        ASSERT_EQ(window.size(), queue.size());
+    }
+}
+
+TEST_F(AggregateQueueTests, MinMaxSumGcdMatchRescan) {
+    checkAgainstRescan<AggregateQueue<long, MinMonoid<long>>, MinMonoid<long>>(1000);
+    checkAgainstRescan<AggregateQueue<long, MaxMonoid<long>>, MaxMonoid<long>>(1000);
+    checkAgainstRescan<AggregateQueue<long, SumMonoid<long>>, SumMonoid<long>>(1000);
+    checkAgainstRescan<AggregateQueue<long, GcdMonoid<long>>, GcdMonoid<long>>(64);
+}
+
+TEST_F(AggregateQueueTests, MonotonicMinMaxMatchRescanWithDuplicates) {
+    checkAgainstRescan<MonotonicAggregateQueue<long, MinMonoid<long>>, MinMonoid<long>>(8);
+    checkAgainstRescan<MonotonicAggregateQueue<long, MaxMonoid<long>>, MaxMonoid<long>>(8);
+    checkAgainstRescan<MonotonicAggregateQueue<long, MinMonoid<long>>, MinMonoid<long>>(100000);
+}
+
+TEST_F(AggregateQueueTests, CombinesOldestFirst) {
+    AggregateQueue<std::string, ConcatMonoid> queue;
+    queue.add("a");
+    queue.add("b");
+    ASSERT_EQ("ab", queue.aggregate());
+    ASSERT_EQ("a", queue.remove());
+    queue.add("c");
+    queue.add("d");
+    ASSERT_EQ("bcd", queue.aggregate());
+}
+
+TEST_F(AggregateQueueTests, EmptyQueue) {
+    using SumQueue = AggregateQueue<int, SumMonoid<int>>;
+    SumQueue sum;
+    ASSERT_EQ(0, sum.aggregate());
+    ASSERT_THROW(sum.remove(), SumQueue::QueueIsEmptyException);
+
+    using MinQueue = MonotonicAggregateQueue<int, MinMonoid<int>>;
+    MinQueue min;
+    ASSERT_EQ(std::numeric_limits<int>::max(), min.aggregate());
+    ASSERT_THROW(min.remove(), MinQueue::QueueIsEmptyException);
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "ringqueue.hpp"
+#include "stack.hpp"
+
+// Monoids for AggregateQueue: an associative combine and its identity. combine(a, b) is
+// called with a older than b, so the operation does not have to be commutative.
+template<typename T>
+struct MinMonoid {
+    static T identity() {
+        return std::numeric_limits<T>::max();
+    }
+
+    static T combine(const T &a, const T &b) {
+        return std::min(a, b);
+    }
+
+    // true if a is strictly preferred over b, used by the monotonic queue
+    static bool prefers(const T &a, const T &b) {
+        return a < b;
+    }
+};
+
+template<typename T>
+struct MaxMonoid {
+    static T identity() {
+        return std::numeric_limits<T>::lowest();
+    }
+
+    static T combine(const T &a, const T &b) {
+        return std::max(a, b);
+    }
+
+    static bool prefers(const T &a, const T &b) {
+        return b < a;
+    }
+};
+
+template<typename T>
+struct SumMonoid {
+    static T identity() {
+        return T();
+    }
+
+    static T combine(const T &a, const T &b) {
+        return a + b;
+    }
+};
+
+template<typename T>
+struct GcdMonoid {
+    static T identity() {
+        return T();
+    }
+
+    static T combine(T a, T b) {
+        while (b != 0) {
+            T r = a % b;
+            a = b;
+            b = r;
+        }
+        return a < 0 ? -a : a;
+    }
+};
+
+// Queue that also returns the combination of all its values, oldest first, in amortized
+// O(1) time. It is MyQueue from 3.4 built on two aggregate stacks in the spirit of
+// StackMin from 3.2: new values go on the back stack, which only keeps the combination
+// of all its values. When the front stack runs dry the back stack is moved onto it, and
+// every front entry stores the combination of itself and every newer value in the front
+// stack, so the top entry holds the aggregate of the whole front stack.
+template<typename T, typename Monoid>
+class AggregateQueue {
+public:
+    AggregateQueue() : backAggregate(Monoid::identity()) {
+    }
+
+    template<typename U>
+    void add(U &&value) {
+        backAggregate = Monoid::combine(backAggregate, value);
+        back.push(std::forward<U>(value));
+    }
+
+    T &peek() {
+        if (front.isEmpty())
+            moveBackToFront();
+        return front.peek().value;
+    }
+
+    T remove() {
+        if (front.isEmpty())
+            moveBackToFront();
+        return front.pop().value;
+    }
+
+    // Combination of all values in the queue, the identity if it is empty
+    T aggregate() {
+        if (front.isEmpty())
+            return backAggregate;
+        return Monoid::combine(front.peek().aggregate, backAggregate);
+    }
+
+    bool isEmpty() const {
+        return front.isEmpty() && back.isEmpty();
+    }
+
+    size_t size() const {
+        return front.size() + back.size();
+    }
+
+    class QueueIsEmptyException {
+    };
+
+private:
+    struct Entry {
+        T value;
+        T aggregate;   // combination of this value and every newer value in the front stack
+    };
+
+    void moveBackToFront() {
+        if (back.isEmpty())
+            throw QueueIsEmptyException();
+        T aggregate = Monoid::identity();
+        while (!back.isEmpty()) {
+            T value = back.pop();
+            aggregate = Monoid::combine(value, aggregate);
+            front.push(Entry{std::move(value), aggregate});
+        }
+        backAggregate = Monoid::identity();
+    }
+
+    Stack<Entry> front;   // oldest value on top
+    Stack<T> back;        // newest value on top
+    T backAggregate;
+};
+
+// Queue for min or max only. Next to the values it keeps a monotonic deque of the values
+// that can still become the aggregate: a new value evicts every older value it is
+// preferred over, so the front of the deque is always the aggregate. Every value is added
+// to and removed from the deque at most once, and there is no bulk move of the whole
+// queue. It needs less memory than AggregateQueue, but on random and trending streams the
+// unpredictable evictions make it slower, so AggregateQueue does not switch to it.
+template<typename T, typename Monoid>
+class MonotonicAggregateQueue {
+public:
+    template<typename U>
+    void add(U &&value) {
+        while (!candidates.isEmpty() && Monoid::prefers(value, candidates.peekLast()))
+            candidates.removeLast();
+        candidates.add(value);
+        values.add(std::forward<U>(value));
+    }
+
+    T &peek() {
+        if (values.isEmpty())
+            throw QueueIsEmptyException();
+        return values.peek();
+    }
+
+    T remove() {
+        if (values.isEmpty())
+            throw QueueIsEmptyException();
+        T value = values.remove();
+        // equal values are all kept, so the front candidate is removed with its own value
+        if (!Monoid::prefers(candidates.peek(), value) && !Monoid::prefers(value, candidates.peek()))
+            candidates.remove();
+        return value;
+    }
+
+    T aggregate() {
+        return candidates.isEmpty() ? Monoid::identity() : candidates.peek();
+    }
+
+    bool isEmpty() const {
+        return values.isEmpty();
+    }
+
+    size_t size() const {
+        return values.size();
+    }
+
+    class QueueIsEmptyException {
+    };
+
+private:
+    RingQueue<T> values;
+    RingQueue<T> candidates;   // strictly monotonic except for equal values, front is the aggregate
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+// Timing helpers shared by the --benchmark modes of the chapter 3 programs.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Wall clock time of fn in nanoseconds
+template<typename Fn>
+double timeNs(Fn &&fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Keeps a result alive so the benchmarked work is not optimised away
+inline volatile std::uintptr_t &benchmarkSink() {
+    static volatile std::uintptr_t sink = 0;
+    return sink;
+}
+
+template<typename T>
+void consume(const T &value) {
+    benchmarkSink() = static_cast<std::uintptr_t>(value);
+}
+
+inline void reportNsPerOp(const std::string &name, size_t ops, double ns) {
+    std::ostringstream line;
+    line << std::left << std::setw(48) << name << std::right << std::setw(12) << ops
+         << std::setw(12) << std::fixed << std::setprecision(2) << ns / ops << " ns/op";
+    std::cout << line.str() << std::endl;
+}
+
+inline void reportThroughput(const std::string &name, size_t messages, double ns) {
+    std::ostringstream line;
+    line << std::left << std::setw(48) << name << std::right << std::setw(12) << messages
+         << std::setw(12) << std::fixed << std::setprecision(2) << messages * 1e3 / ns << " M msg/s";
+    std::cout << line.str() << std::endl;
+}
+
+// Prints percentiles of latency samples given in nanoseconds
+inline void reportPercentiles(const std::string &name, std::vector<double> samples) {
+    if (samples.empty())
+        return;
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double p) {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))];
+    };
+    std::ostringstream line;
+    line << std::left << std::setw(48) << name << std::fixed << std::setprecision(0)
+         << " p50 " << at(0.5) << " p90 " << at(0.9) << " p99 " << at(0.99)
+         << " p99.9 " << at(0.999) << " max " << samples.back() << " ns";
+    std::cout << line.str() << std::endl;
+}
+
+// Prints how many latency samples, given in nanoseconds, fall into each power of two bucket
+inline void reportHistogram(const std::string &name, const std::vector<double> &samples) {
+    std::vector<size_t> buckets;
+    for (double sample : samples) {
+        size_t bucket = 0;
+        while (bucket < 63 && sample >= static_cast<double>(uint64_t(2) << bucket))
+            ++bucket;
+        if (bucket >= buckets.size())
+            buckets.resize(bucket + 1);
+        ++buckets[bucket];
+    }
+    std::cout << name << std::endl;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        if (buckets[bucket] == 0)
+            continue;
+        std::ostringstream line;
+        line << "    < " << std::left << std::setw(16) << std::to_string(uint64_t(2) << bucket) + " ns"
+             << std::right << std::setw(12) << buckets[bucket];
+        std::cout << line.str() << std::endl;
+    }
+}
+
+// Number of operations for a `--benchmark [ops]` run, 0 when not started with --benchmark
+inline size_t benchmarkOps(int argc, char **argv, size_t defaultOps) {
+    if (argc < 2 || std::string(argv[1]) != "--benchmark")
+        return 0;
+    return argc > 2 ? std::stoull(argv[2]) : defaultOps;
+}
@@ -0,0 +1,65 @@
+// Throughput of BlockingQueue with consumers taking one value per call against taking up
+// to 64 values per wakeup, for a roomy and a tight capacity. The counters show how often
+// each side had to park and for how long.
+
+#include <atomic>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include "benchmark.hpp"
+#include "blockingqueue.hpp"
+
+void run(size_t messages, unsigned producers, unsigned consumers, size_t capacity, size_t batch) {
+    BlockingQueue<long> queue(capacity);
+    std::atomic<unsigned> running(producers);
+    double ns = timeNs([&] {
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                size_t begin = messages * p / producers;
+                size_t end = messages * (p + 1) / producers;
+                for (size_t i = begin; i < end; ++i)
+                    queue.add(static_cast<long>(i));
+                if (running.fetch_sub(1) == 1)
+                    queue.close();
+            });
+        }
+        for (unsigned c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                std::vector<long> values(batch);
+                size_t n;
+                while ((n = queue.remove_n(values.begin(), batch)) > 0)
+                    consume(values[n - 1]);
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    });
+
+    std::string name = std::to_string(producers) + "P/" + std::to_string(consumers) + "C cap " +
+                       std::to_string(capacity) + (batch == 1 ? " remove" : " remove_n(" + std::to_string(batch) + ")");
+    reportThroughput(name, messages, ns);
+    BlockingQueueStats stats = queue.getStats();
+    std::cout << "    " << stats.removed / stats.removeCalls << " values per remove, "
+              << stats.producerWaits << " producer waits ("
+              << (stats.producerWaits ? stats.producerWaitNs / stats.producerWaits : 0) << " ns avg), "
+              << stats.consumerWaits << " consumer waits ("
+              << (stats.consumerWaits ? stats.consumerWaitNs / stats.consumerWaits : 0) << " ns avg), max depth "
+              << stats.maxDepth << std::endl;
+}
+
+int main(int argc, char **argv) {
+    size_t messages = benchmarkOps(argc, argv, 4000000);
+    if (messages == 0)
+        messages = 4000000;
+
+    std::vector<std::pair<unsigned, unsigned>> shapes = {{1, 1}, {4, 1}, {1, 4}, {4, 4}};
+    for (auto shape : shapes) {
+        for (size_t capacity : {size_t(1024), size_t(16)}) {
+            run(messages, shape.first, shape.second, capacity, 1);
+            run(messages, shape.first, shape.second, capacity, 64);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include "blockingqueue.hpp"
+
+class BlockingQueueTests : public ::testing::Test {
+public:
+    BlockingQueueTests() = default;
+};
+
+using IntQueue = BlockingQueue<int>;
+
+TEST_F(BlockingQueueTests, CapacityAndTimeouts) {
+    IntQueue queue(2);
+    ASSERT_TRUE(queue.try_add(1));
+    int two = 2;
+    queue.add(two);
+    ASSERT_FALSE(queue.try_add(3));
+    ASSERT_FALSE(queue.add_for(3, std::chrono::milliseconds(5)));
+    ASSERT_EQ(2u, queue.size());
+
+    ASSERT_EQ(1, queue.remove());
+    int value = 0;
+    ASSERT_TRUE(queue.remove_for(value, std::chrono::milliseconds(5)));
+    ASSERT_EQ(2, value);
+    ASSERT_FALSE(queue.try_remove(value));
+    ASSERT_FALSE(queue.remove_for(value, std::chrono::milliseconds(5)));
+    std::vector<int> values;
+    ASSERT_EQ(0u, queue.remove_n_for(std::back_inserter(values), 4, std::chrono::milliseconds(5)));
+
+    BlockingQueueStats stats = queue.getStats();
+    ASSERT_EQ(2u, stats.added);
+    ASSERT_EQ(2u, stats.removed);
+    ASSERT_EQ(2u, stats.maxDepth);
+    ASSERT_EQ(0u, stats.depth);
+    ASSERT_EQ(1u, stats.producerWaits);
+    ASSERT_EQ(2u, stats.consumerWaits);
+}
+
+TEST_F(BlockingQueueTests, CloseWakesWaitersAndDrains) {
+    IntQueue queue(1);
+    queue.add(1);
+    std::thread producer([&] {
+        ASSERT_THROW(queue.add(2), IntQueue::QueueIsClosedException);
+    });
+    while (queue.getStats().producerWaits == 0)
+        std::this_thread::yield();
+    queue.close();
+    producer.join();
+
+    ASSERT_TRUE(queue.isClosed());
+    ASSERT_FALSE(queue.try_add(3));
+    ASSERT_FALSE(queue.add_for(3, std::chrono::milliseconds(5)));
+    ASSERT_EQ(1, queue.remove());
+    ASSERT_THROW(queue.remove(), IntQueue::QueueIsClosedException);
+    std::vector<int> values;
+    ASSERT_EQ(0u, queue.remove_n(std::back_inserter(values), 8));
+
+    IntQueue empty(4);
+    std::thread consumer([&] {
+        std::vector<int> none;
+        ASSERT_EQ(0u, empty.remove_n(std::back_inserter(none), 8));
+    });
+    while (empty.getStats().consumerWaits == 0)
+        std::this_thread::yield();
+    empty.close();
+    consumer.join();
+}
+
+// Producers fill a small queue while consumers take single values and batches, until the
+// last producer closes it. Every value must arrive exactly once, and in order per producer.
+TEST_F(BlockingQueueTests, ProducersAndBatchConsumersLoseNothing) {
+    const int Producers = 3, Consumers = 3, PerProducer = 20000;
+    IntQueue queue(16);
+    std::atomic<int> running(Producers);
+    std::vector<std::vector<int>> received(Consumers);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < Producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < PerProducer; ++i)
+                queue.add(p * PerProducer + i);
+            if (running.fetch_sub(1) == 1)
+                queue.close();
+        });
+    }
+    for (int c = 0; c < Consumers; ++c) {
+        threads.emplace_back([&, c] {
+            size_t batch = c == 0 ? 1 : 7 * c;
+            while (queue.remove_n(std::back_inserter(received[c]), batch) > 0) {
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    std::vector<int> all;
+    for (auto &values : received) {
+        std::vector<int> last(Producers, -1);
+        for (int value : values) {
+            ASSERT_LT(last[value / PerProducer], value);
+            last[value / PerProducer] = value;
+        }
+        all.insert(all.end(), values.begin(), values.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(static_cast<size_t>(Producers * PerProducer), all.size());
+    for (int i = 0; i < Producers * PerProducer; ++i)
+        ASSERT_EQ(i, all[i]);
+    ASSERT_LE(queue.getStats().maxDepth, 16u);
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include "queue.hpp"
+
+// Counters of a BlockingQueue. Waits are only counted, and timed, when a thread actually
+// had to park, so an uncontended add or remove does not read the clock.
+struct BlockingQueueStats {
+    size_t depth;              // values in the queue when the stats were taken
+    size_t maxDepth;           // most values ever in the queue at once
+    uint64_t added;
+    uint64_t removed;
+    uint64_t removeCalls;      // remove, remove_n and their try and timed forms that got values
+    uint64_t producerWaits;    // times a producer parked because the queue was full
+    uint64_t producerWaitNs;
+    uint64_t consumerWaits;    // times a consumer parked because the queue was empty
+    uint64_t consumerWaitNs;
+};
+
+// Queue<T> with a capacity, guarded by a std::mutex. Producers park on a condition variable
+// while it is full and consumers while it is empty, with or without a timeout. The
+// condition variables are only notified when the other side has a thread parked, so a
+// queue that never fills or drains makes no futex calls.
+//
+// remove_n hands up to n values to a consumer per wakeup, which takes the lock, the
+// wakeup and the notify of the producers once for the whole batch.
+//
+// close() wakes every parked thread. Adding to a closed queue throws QueueIsClosedException
+// (the try and timed forms return false), values already in it can still be removed, and
+// remove on a closed and drained queue throws QueueIsClosedException, while remove_n
+// returns 0.
+template<typename T>
+class BlockingQueue {
+public:
+    explicit BlockingQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1), closed(false),
+                                              waitingProducers(0), waitingConsumers(0), stats() {
+    }
+
+    // Blocks while the queue is full
+    template<typename U>
+    void add(U &&value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        waitForSpace(lock, nullptr);
+        push(lock, std::forward<U>(value));
+    }
+
+    // Returns false if the queue is full or closed. value is only consumed on success.
+    template<typename U>
+    bool try_add(U &&value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (closed || queue.size() >= capacity)
+            return false;
+        push(lock, std::forward<U>(value));
+        return true;
+    }
+
+    // Returns false if the queue stayed full for timeout or is closed
+    template<typename U, typename Rep, typename Period>
+    bool add_for(U &&value, const std::chrono::duration<Rep, Period> &timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!waitForSpace(lock, &deadline))
+            return false;
+        push(lock, std::forward<U>(value));
+        return true;
+    }
+
+    // Blocks while the queue is empty
+    T remove() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!waitForValues(lock, nullptr))
+            throw QueueIsClosedException();
+        T value = queue.remove();
+        popped(lock, 1);
+        return value;
+    }
+
+    // Returns false if the queue is empty
+    bool try_remove(T &value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (queue.isEmpty())
+            return false;
+        value = queue.remove();
+        popped(lock, 1);
+        return true;
+    }
+
+    // Returns false if the queue stayed empty for timeout or is closed and drained
+    template<typename Rep, typename Period>
+    bool remove_for(T &value, const std::chrono::duration<Rep, Period> &timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!waitForValues(lock, &deadline))
+            return false;
+        value = queue.remove();
+        popped(lock, 1);
+        return true;
+    }
+
+    // Blocks while the queue is empty, then moves up to n values into out. Returns how many
+    // were moved, 0 only if the queue is closed and drained.
+    template<typename OutputIt>
+    size_t remove_n(OutputIt out, size_t n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (n == 0 || !waitForValues(lock, nullptr))
+            return 0;
+        return take(lock, out, n);
+    }
+
+    // As remove_n, but returns 0 if the queue stayed empty for timeout
+    template<typename OutputIt, typename Rep, typename Period>
+    size_t remove_n_for(OutputIt out, size_t n, const std::chrono::duration<Rep, Period> &timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (n == 0 || !waitForValues(lock, &deadline))
+            return 0;
+        return take(lock, out, n);
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    bool isClosed() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closed;
+    }
+
+    // Only a snapshot while other threads are using the queue
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.size();
+    }
+
+    BlockingQueueStats getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        BlockingQueueStats snapshot = stats;
+        snapshot.depth = queue.size();
+        return snapshot;
+    }
+
+    class QueueIsClosedException {
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Parks until there is space or the queue is closed. Throws on a closed queue unless
+    // there is a deadline, returns false if the deadline passed.
+    bool waitForSpace(std::unique_lock<std::mutex> &lock, const Clock::time_point *deadline) {
+        if (!closed && queue.size() >= capacity) {
+            auto start = Clock::now();
+            ++waitingProducers;
+            ++stats.producerWaits;
+            auto ready = [this] { return closed || queue.size() < capacity; };
+            if (deadline)
+                notFull.wait_until(lock, *deadline, ready);
+            else
+                notFull.wait(lock, ready);
+            --waitingProducers;
+            stats.producerWaitNs += elapsedNs(start);
+        }
+        if (closed) {
+            if (deadline)
+                return false;
+            throw QueueIsClosedException();
+        }
+        return queue.size() < capacity;
+    }
+
+    // Parks until there is a value or the queue is closed. Returns false if there is no
+    // value: the queue is closed and drained or the deadline passed.
+    bool waitForValues(std::unique_lock<std::mutex> &lock, const Clock::time_point *deadline) {
+        if (!closed && queue.isEmpty()) {
+            auto start = Clock::now();
+            ++waitingConsumers;
+            ++stats.consumerWaits;
+            auto ready = [this] { return closed || !queue.isEmpty(); };
+            if (deadline)
+                notEmpty.wait_until(lock, *deadline, ready);
+            else
+                notEmpty.wait(lock, ready);
+            --waitingConsumers;
+            stats.consumerWaitNs += elapsedNs(start);
+        }
+        return !queue.isEmpty();
+    }
+
+    template<typename U>
+    void push(std::unique_lock<std::mutex> &lock, U &&value) {
+        queue.add(std::forward<U>(value));
+        ++stats.added;
+        if (queue.size() > stats.maxDepth)
+            stats.maxDepth = queue.size();
+        bool wake = waitingConsumers > 0;
+        lock.unlock();
+        if (wake)
+            notEmpty.notify_one();
+    }
+
+    template<typename OutputIt>
+    size_t take(std::unique_lock<std::mutex> &lock, OutputIt out, size_t n) {
+        size_t taken = 0;
+        for (; taken < n && !queue.isEmpty(); ++taken, ++out)
+            *out = queue.remove();
+        popped(lock, taken);
+        return taken;
+    }
+
+    // A value left for another consumer is handed on, as the notify that woke this one
+    // may have been meant for a single value
+    void popped(std::unique_lock<std::mutex> &lock, size_t n) {
+        stats.removed += n;
+        ++stats.removeCalls;
+        bool wakeProducers = waitingProducers > 0;
+        bool wakeConsumer = waitingConsumers > 0 && !queue.isEmpty();
+        lock.unlock();
+        if (wakeProducers) {
+            if (n == 1)
+                notFull.notify_one();
+            else
+                notFull.notify_all();
+        }
+        if (wakeConsumer)
+            notEmpty.notify_one();
+    }
+
+    static uint64_t elapsedNs(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    const size_t capacity;
+    mutable std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    Queue<T> queue;
+    bool closed;
+    size_t waitingProducers;
+    size_t waitingConsumers;
+    BlockingQueueStats stats;
+};
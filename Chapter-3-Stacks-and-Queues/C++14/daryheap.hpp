@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Implicit heap in a vector where every node has Arity children. peek returns the value
+// that comes first under Compare, so with the default std::less it is a min-heap, the
+// order of a sorted stack. A larger arity makes the tree shallower: push gets cheaper and
+// pop compares more children per level, but the children of a node share cache lines.
+template<typename T, size_t Arity = 4, typename Compare = std::less<T>>
+class DaryHeap {
+public:
+    static_assert(Arity >= 2, "Arity must be at least 2");
+
+    explicit DaryHeap(Compare compare = Compare()) : compare(compare) {
+    }
+
+    template<typename U>
+    void push(U &&value) {
+        values.push_back(std::forward<U>(value));
+        siftUp(values.size() - 1);
+    }
+
+    const T &peek() const {
+        if (values.empty())
+            throw HeapIsEmptyException();
+        return values.front();
+    }
+
+    T pop() {
+        if (values.empty())
+            throw HeapIsEmptyException();
+        T top = std::move(values.front());
+        T last = std::move(values.back());
+        values.pop_back();
+        if (!values.empty())
+            siftDown(0, std::move(last));
+        return top;
+    }
+
+    bool isEmpty() const {
+        return values.empty();
+    }
+
+    size_t size() const {
+        return values.size();
+    }
+
+    void reserve(size_t capacity) {
+        values.reserve(capacity);
+    }
+
+    class HeapIsEmptyException {
+    };
+
+private:
+    // Moves the hole up instead of swapping, one move per level
+    void siftUp(size_t i) {
+        T value = std::move(values[i]);
+        while (i > 0) {
+            size_t parent = (i - 1) / Arity;
+            if (!compare(value, values[parent]))
+                break;
+            values[i] = std::move(values[parent]);
+            i = parent;
+        }
+        values[i] = std::move(value);
+    }
+
+    // Fills the hole at i with value, moving the first child up while it comes first
+    void siftDown(size_t i, T value) {
+        const size_t n = values.size();
+        for (;;) {
+            size_t first = i * Arity + 1;
+            if (first >= n)
+                break;
+            size_t last = first + Arity < n ? first + Arity : n;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (compare(values[child], values[best]))
+                    best = child;
+            }
+            if (!compare(values[best], value))
+                break;
+            values[i] = std::move(values[best]);
+            i = best;
+        }
+        values[i] = std::move(value);
+    }
+
+    std::vector<T> values;
+    Compare compare;
+};
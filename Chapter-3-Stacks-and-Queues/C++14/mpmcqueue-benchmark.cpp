@@ -0,0 +1,80 @@
+// Throughput of MpmcQueue with N producers and M consumers, against a Queue guarded by a
+// std::mutex and a condition variable.
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "benchmark.hpp"
+#include "mpmcqueue.hpp"
+#include "queue.hpp"
+
+// Queue<T> behind a mutex, remove blocks on a condition variable while the queue is empty
+template<typename T>
+class MutexQueue {
+public:
+    template<typename U>
+    void add(U &&value) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.add(std::forward<U>(value));
+        }
+        notEmpty.notify_one();
+    }
+
+    void remove(T &value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return !queue.isEmpty(); });
+        value = queue.remove();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    Queue<T> queue;
+};
+
+template<typename Q>
+void run(const std::string &name, Q &queue, size_t messages, unsigned producers, unsigned consumers) {
+    std::atomic<size_t> claimed(0);
+    double ns = timeNs([&] {
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                size_t begin = messages * p / producers;
+                size_t end = messages * (p + 1) / producers;
+                for (size_t i = begin; i < end; ++i)
+                    queue.add(static_cast<long>(i));
+            });
+        }
+        for (unsigned c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                long value;
+                while (claimed.fetch_add(1, std::memory_order_relaxed) < messages) {
+                    queue.remove(value);
+                    consume(value);
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    });
+    reportThroughput(name + " " + std::to_string(producers) + "P/" + std::to_string(consumers) + "C",
+                     messages, ns);
+}
+
+int main(int argc, char **argv) {
+    size_t messages = benchmarkOps(argc, argv, 10000000);
+    if (messages == 0)
+        messages = 10000000;
+
+    std::vector<std::pair<unsigned, unsigned>> shapes = {{1, 1}, {2, 2}, {4, 4}, {1, 4}, {4, 1}};
+    for (auto shape : shapes) {
+        MpmcQueue<long> mpmc(1024);
+        run("MpmcQueue", mpmc, messages, shape.first, shape.second);
+        MutexQueue<long> locked;
+        run("std::mutex + Queue", locked, messages, shape.first, shape.second);
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "mpmcqueue.hpp"
+
+class MpmcQueueTests : public ::testing::Test {
+public:
+    MpmcQueueTests() = default;
+
+    struct Received {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t xorSum = 0;
+        bool inOrder = true;
+    };
+
+    // Every producer thread adds perProducer values, producer * perProducer + i in order of
+    // i, and the consumer threads share out the removes until all of them are taken. Every
+    // consumer checks that the values it gets from any one producer keep increasing.
+    template<typename Add, typename Remove>
+    static Received exchange(int producers, int consumers, int perProducer, Add add, Remove remove) {
+        const uint64_t total = static_cast<uint64_t>(producers) * perProducer;
+        std::atomic<uint64_t> taken(0);
+        std::vector<Received> received(consumers);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([=] {
+                for (int i = 0; i < perProducer; ++i)
+                    add(p * perProducer + i);
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c] {
+                std::vector<int> last(producers, -1);
+                Received &mine = received[c];
+                while (taken.fetch_add(1) < total) {
+                    int value = remove();
+                    int producer = value / perProducer;
+                    if (value <= last[producer])
+                        mine.inOrder = false;
+                    last[producer] = value;
+                    ++mine.count;
+                    mine.sum += value;
+                    mine.xorSum ^= value;
+                }
+            });
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+
+        Received all;
+        for (const Received &mine : received) {
+            all.count += mine.count;
+            all.sum += mine.sum;
+            all.xorSum ^= mine.xorSum;
+            all.inOrder = all.inOrder && mine.inOrder;
+        }
+        return all;
+    }
+
+    static void checkExchange(const Received &all, int producers, int perProducer) {
+        const int total = producers * perProducer;
+        uint64_t xorSum = 0;
+        for (int value = 0; value < total; ++value)
+            xorSum ^= value;
+        ASSERT_EQ(static_cast<uint64_t>(total), all.count);
+        ASSERT_EQ(static_cast<uint64_t>(total) * (total - 1) / 2, all.sum);
+        ASSERT_EQ(xorSum, all.xorSum);
+        ASSERT_TRUE(all.inOrder);
+    }
+};
+
+TEST_F(MpmcQueueTests, TryAddFailsWhenFullAndTryRemoveWhenEmpty) {
+    MpmcQueue<int> queue(3);
+    ASSERT_EQ(4u, queue.capacity());
+    int value;
+    ASSERT_FALSE(queue.try_remove(value));
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(queue.try_add(i));
+    ASSERT_FALSE(queue.try_add(4));
+    ASSERT_EQ(4u, queue.size());
+
+    // around the ring a few times, so the sequence numbers go through several laps
+    for (int i = 4; i < 20; ++i) {
+        ASSERT_TRUE(queue.try_remove(value));
+        ASSERT_EQ(i - 4, value);
+        ASSERT_TRUE(queue.try_add(i));
+        ASSERT_FALSE(queue.try_add(i));
+    }
+    for (int i = 16; i < 20; ++i) {
+        ASSERT_TRUE(queue.try_remove(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_FALSE(queue.try_remove(value));
+    ASSERT_TRUE(queue.isEmpty());
+}
+
+// Non-blocking calls through a small queue, so it keeps running full and empty
+TEST_F(MpmcQueueTests, TryAddAndTryRemoveStress) {
+    const int producers = 4;
+    const int perProducer = 100000;
+    MpmcQueue<int> queue(64);
+    Received all = exchange(producers, 3, perProducer, [&](int value) {
+        while (!queue.try_add(value))
+            std::this_thread::yield();
+    }, [&] {
+        int value;
+        while (!queue.try_remove(value))
+            std::this_thread::yield();
+        return value;
+    });
+    checkExchange(all, producers, perProducer);
+    ASSERT_TRUE(queue.isEmpty());
+}
+
+// A capacity of 2 keeps both sides waiting on each other, long enough to park
+TEST_F(MpmcQueueTests, BlockingAddAndRemoveStress) {
+    const int producers = 3;
+    const int perProducer = 20000;
+    MpmcQueue<int> queue(1);
+    ASSERT_EQ(2u, queue.capacity());
+    Received all = exchange(producers, 3, perProducer, [&](int value) {
+        queue.add(value);
+    }, [&] {
+        int value;
+        queue.remove(value);
+        return value;
+    });
+    checkExchange(all, producers, perProducer);
+    ASSERT_TRUE(queue.isEmpty());
+}
+
+// The waiting side spins and yields for only a few hundred attempts, so after a 20 ms
+// sleep it is parked on the condition variable when the other side makes progress.
+TEST_F(MpmcQueueTests, ParkedWaitersAreWoken) {
+    MpmcQueue<int> queue(2);
+    std::thread producer([&] {
+        for (int i = 0; i < 4; ++i)
+            queue.add(i);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(2u, queue.size());
+    int value;
+    for (int i = 0; i < 4; ++i) {
+        queue.remove(value);
+        EXPECT_EQ(i, value);
+    }
+    producer.join();
+
+    std::thread consumer([&] {
+        int received;
+        for (int i = 0; i < 2; ++i) {
+            queue.remove(received);
+            ASSERT_EQ(i, received);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.add(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.add(1);
+    consumer.join();
+    ASSERT_TRUE(queue.isEmpty());
+}
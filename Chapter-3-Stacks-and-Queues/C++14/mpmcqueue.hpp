@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+
+// Bounded multi-producer/multi-consumer queue (Dmitry Vyukov's design). Every cell carries
+// a sequence number telling whether it is ready to be written (sequence == position) or
+// read (sequence == position + 1) in the current lap. Producers and consumers claim
+// positions with a CAS on their own counter and never touch the other side's counter.
+//
+// try_add/try_remove never block. add/remove spin, then yield, then park on a condition
+// variable until the other side makes progress.
+template<typename T>
+class MpmcQueue {
+public:
+    static constexpr size_t CacheLine = 64;
+
+    // Capacity is rounded up to a power of two
+    explicit MpmcQueue(size_t minCapacity) : mask(0), enqueuePos(0), dequeuePos(0),
+                                             waitingProducers(0), waitingConsumers(0) {
+        size_t capacity = 2;
+        while (capacity < minCapacity)
+            capacity *= 2;
+        mask = capacity - 1;
+        cells = new Cell[capacity];
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    ~MpmcQueue() {
+        size_t end = enqueuePos.load(std::memory_order_relaxed);
+        for (size_t pos = dequeuePos.load(std::memory_order_relaxed); pos != end; ++pos)
+            cells[pos & mask].value()->~T();
+        delete[] cells;
+    }
+
+    // Returns false if the queue is full. value is only consumed on success.
+    template<typename U>
+    bool try_add(U &&value) {
+        Cell *cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        new(cell->value()) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false if the queue is empty
+    bool try_remove(T &value) {
+        Cell *cell;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(*cell->value());
+        cell->value()->~T();
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Blocks while the queue is full
+    template<typename U>
+    void add(U &&value) {
+        for (unsigned attempt = 0; !try_add(std::forward<U>(value)); ++attempt)
+            backoff(attempt, waitingProducers, [this] { return canAdd(); });
+        wake(waitingConsumers);
+    }
+
+    // Blocks while the queue is empty
+    void remove(T &value) {
+        for (unsigned attempt = 0; !try_remove(value); ++attempt)
+            backoff(attempt, waitingConsumers, [this] { return canRemove(); });
+        wake(waitingProducers);
+    }
+
+    // Only a snapshot while other threads are using the queue
+    size_t size() const {
+        size_t enqueued = enqueuePos.load(std::memory_order_acquire);
+        size_t dequeued = dequeuePos.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    struct Cell {
+        T *value() {
+            return reinterpret_cast<T *>(storage);
+        }
+
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr unsigned SpinAttempts = 64;
+    static constexpr unsigned YieldAttempts = 128;
+
+    bool canAdd() {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        return cells[pos & mask].sequence.load(std::memory_order_acquire) == pos;
+    }
+
+    bool canRemove() {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        return cells[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // Spin, then yield, then park until ready() or a wake-up from the other side. The
+    // timed wait bounds the cost of a wake-up racing with the waiter going to sleep.
+    template<typename Ready>
+    void backoff(unsigned attempt, std::atomic<unsigned> &waiting, Ready ready) {
+        if (attempt < SpinAttempts)
+            return;
+        if (attempt < SpinAttempts + YieldAttempts) {
+            std::this_thread::yield();
+            return;
+        }
+        std::unique_lock<std::mutex> lock(parkMutex);
+        waiting.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        parked.wait_for(lock, std::chrono::milliseconds(1), ready);
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wake(std::atomic<unsigned> &waiting) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            parked.notify_all();
+        }
+    }
+
+    // read-only after construction
+    alignas(CacheLine) Cell *cells;
+    size_t mask;
+
+    alignas(CacheLine) std::atomic<size_t> enqueuePos;
+    alignas(CacheLine) std::atomic<size_t> dequeuePos;
+
+    alignas(CacheLine) std::atomic<unsigned> waitingProducers;
+    std::atomic<unsigned> waitingConsumers;
+    std::mutex parkMutex;
+    std::condition_variable parked;
+};
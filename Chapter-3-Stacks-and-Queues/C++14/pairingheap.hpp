@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Pairing heap with the DaryHeap interface, and decreaseKey through the handle push
+// returns. Nodes live in one vector and point at each other by index, with popped nodes
+// kept on a free list, so a handle stays valid until its value is popped.
+//
+// Every node keeps its first child, its next sibling and prev, which is the previous
+// sibling or, for a first child, the parent. push and decreaseKey link one tree with the
+// root in O(1); pop merges the root's children in two passes, pairing them left to right
+// and then folding the pairs right to left, in O(log n) amortized.
+template<typename T, typename Compare = std::less<T>>
+class PairingHeap {
+public:
+    class Handle {
+    public:
+        Handle() : node(None) {
+        }
+
+    private:
+        friend class PairingHeap;
+
+        explicit Handle(size_t node) : node(node) {
+        }
+
+        size_t node;
+    };
+
+    explicit PairingHeap(Compare compare = Compare()) : compare(compare), root(None), freeList(None),
+                                                          heapSize(0) {
+    }
+
+    template<typename U>
+    Handle push(U &&value) {
+        size_t n = allocate(std::forward<U>(value));
+        root = root == None ? n : link(root, n);
+        ++heapSize;
+        return Handle(n);
+    }
+
+    const T &peek() const {
+        if (root == None)
+            throw HeapIsEmptyException();
+        return nodes[root].value;
+    }
+
+    T pop() {
+        if (root == None)
+            throw HeapIsEmptyException();
+        size_t top = root;
+        T value = std::move(nodes[top].value);
+        root = mergeChildren(nodes[top].child);
+        release(top);
+        --heapSize;
+        return value;
+    }
+
+    // Replaces the value of handle by one that does not come after it under Compare
+    void decreaseKey(Handle handle, T value) {
+        size_t n = handle.node;
+        if (compare(nodes[n].value, value))
+            throw KeyIncreasedException();
+        nodes[n].value = std::move(value);
+        if (n == root)
+            return;
+        cut(n);
+        root = link(root, n);
+    }
+
+    const T &value(Handle handle) const {
+        return nodes[handle.node].value;
+    }
+
+    bool isEmpty() const {
+        return root == None;
+    }
+
+    size_t size() const {
+        return heapSize;
+    }
+
+    void reserve(size_t capacity) {
+        nodes.reserve(capacity);
+    }
+
+    class HeapIsEmptyException {
+    };
+
+    class KeyIncreasedException {
+    };
+
+private:
+    static const size_t None = static_cast<size_t>(-1);
+
+    struct Node {
+        T value;
+        size_t child;
+        size_t sibling;
+        size_t prev;   // previous sibling, or the parent of a first child
+    };
+
+    template<typename U>
+    size_t allocate(U &&value) {
+        if (freeList == None) {
+            nodes.push_back(Node{std::forward<U>(value), None, None, None});
+            return nodes.size() - 1;
+        }
+        size_t n = freeList;
+        freeList = nodes[n].sibling;
+        nodes[n] = Node{std::forward<U>(value), None, None, None};
+        return n;
+    }
+
+    void release(size_t n) {
+        nodes[n].sibling = freeList;
+        freeList = n;
+    }
+
+    // Makes the root that comes later the first child of the other one, returns the root
+    size_t link(size_t a, size_t b) {
+        if (compare(nodes[b].value, nodes[a].value))
+            std::swap(a, b);
+        Node &parent = nodes[a];
+        Node &child = nodes[b];
+        child.sibling = parent.child;
+        if (parent.child != None)
+            nodes[parent.child].prev = b;
+        child.prev = a;
+        parent.child = b;
+        parent.sibling = None;
+        parent.prev = None;
+        return a;
+    }
+
+    // Detaches the subtree of n from its parent or previous sibling
+    void cut(size_t n) {
+        Node &node = nodes[n];
+        if (nodes[node.prev].child == n)
+            nodes[node.prev].child = node.sibling;
+        else
+            nodes[node.prev].sibling = node.sibling;
+        if (node.sibling != None)
+            nodes[node.sibling].prev = node.prev;
+        node.sibling = None;
+        node.prev = None;
+    }
+
+    size_t mergeChildren(size_t first) {
+        pairs.clear();
+        while (first != None) {
+            size_t a = first;
+            size_t b = nodes[a].sibling;
+            if (b == None) {
+                pairs.push_back(a);
+                break;
+            }
+            first = nodes[b].sibling;
+            pairs.push_back(link(a, b));
+        }
+        if (pairs.empty())
+            return None;
+        size_t merged = pairs.back();
+        for (size_t i = pairs.size() - 1; i > 0; --i)
+            merged = link(pairs[i - 1], merged);
+        nodes[merged].sibling = None;
+        nodes[merged].prev = None;
+        return merged;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<size_t> pairs;   // scratch space of mergeChildren
+    Compare compare;
+    size_t root;
+    size_t freeList;             // popped nodes, chained through sibling
+    size_t heapSize;
+};
@@ -0,0 +1,177 @@
+// Priority queues from priorityqueue.hpp against std::priority_queue: push all then pop
+// all, the hold model of event simulation (pop the minimum and push it back a random
+// distance later), and Dijkstra on a random graph, where PairingHeap uses decreaseKey and
+// the others push again and skip stale entries.
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "benchmark.hpp"
+#include "priorityqueue.hpp"
+
+using Entry = std::pair<uint64_t, uint32_t>;   // distance, vertex
+
+// std::priority_queue with the push/peek/pop/isEmpty API, smallest on top
+template<typename T>
+class StdPriorityQueue {
+public:
+    void push(const T &value) {
+        queue.push(value);
+    }
+
+    const T &peek() const {
+        return queue.top();
+    }
+
+    T pop() {
+        T value = queue.top();
+        queue.pop();
+        return value;
+    }
+
+    bool isEmpty() const {
+        return queue.empty();
+    }
+
+private:
+    std::priority_queue<T, std::vector<T>, std::greater<T>> queue;
+};
+
+template<typename Heap>
+void pushAllPopAll(const std::string &name, size_t n) {
+    std::mt19937_64 mt(1);
+    Heap heap;
+    reportNsPerOp(name + " push all, pop all", 2 * n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i)
+            heap.push(mt() >> 24);
+        while (!heap.isEmpty())
+            consume(heap.pop());
+    }));
+}
+
+template<typename Heap>
+void hold(const std::string &name, size_t n, size_t depth) {
+    std::mt19937_64 mt(2);
+    Heap heap;
+    for (size_t i = 0; i < depth; ++i)
+        heap.push(mt() % 1000000);
+    reportNsPerOp(name + " hold, depth " + std::to_string(depth), 2 * n, timeNs([&] {
+        for (size_t i = 0; i < n; ++i)
+            heap.push(heap.pop() + mt() % 1000000);
+    }));
+}
+
+// Random directed graph in compressed rows, Degree edges per vertex
+struct Graph {
+    Graph(size_t vertices, size_t degree) : first(vertices + 1) {
+        std::mt19937 mt(3);
+        for (size_t v = 0; v < vertices; ++v) {
+            first[v] = targets.size();
+            for (size_t e = 0; e < degree; ++e) {
+                targets.push_back(static_cast<uint32_t>(mt() % vertices));
+                weights.push_back(1 + mt() % 1000);
+            }
+        }
+        first[vertices] = targets.size();
+    }
+
+    size_t vertices() const {
+        return first.size() - 1;
+    }
+
+    std::vector<size_t> first;
+    std::vector<uint32_t> targets;
+    std::vector<uint64_t> weights;
+};
+
+const uint64_t Unreached = UINT64_MAX;
+
+template<typename Heap>
+void dijkstraLazy(const std::string &name, const Graph &graph) {
+    std::vector<uint64_t> distance;
+    reportNsPerOp(name + " Dijkstra", graph.targets.size(), timeNs([&] {
+        distance.assign(graph.vertices(), Unreached);
+        Heap heap;
+        distance[0] = 0;
+        heap.push(Entry(0, 0));
+        while (!heap.isEmpty()) {
+            Entry entry = heap.pop();
+            uint32_t v = entry.second;
+            if (entry.first > distance[v])
+                continue;
+            for (size_t e = graph.first[v]; e < graph.first[v + 1]; ++e) {
+                uint64_t d = entry.first + graph.weights[e];
+                uint32_t u = graph.targets[e];
+                if (d < distance[u]) {
+                    distance[u] = d;
+                    heap.push(Entry(d, u));
+                }
+            }
+        }
+    }));
+    consume(distance.back());
+}
+
+void dijkstraDecreaseKey(const Graph &graph) {
+    using Heap = PairingHeap<Entry>;
+    std::vector<uint64_t> distance;
+    reportNsPerOp("PairingHeap decreaseKey Dijkstra", graph.targets.size(), timeNs([&] {
+        distance.assign(graph.vertices(), Unreached);
+        std::vector<Heap::Handle> handles(graph.vertices());
+        std::vector<bool> done(graph.vertices(), false);
+        Heap heap;
+        heap.reserve(graph.vertices());
+        distance[0] = 0;
+        handles[0] = heap.push(Entry(0, 0));
+        while (!heap.isEmpty()) {
+            Entry entry = heap.pop();
+            uint32_t v = entry.second;
+            done[v] = true;
+            for (size_t e = graph.first[v]; e < graph.first[v + 1]; ++e) {
+                uint64_t d = entry.first + graph.weights[e];
+                uint32_t u = graph.targets[e];
+                if (done[u] || d >= distance[u])
+                    continue;
+                if (distance[u] == Unreached)
+                    handles[u] = heap.push(Entry(d, u));
+                else
+                    heap.decreaseKey(handles[u], Entry(d, u));
+                distance[u] = d;
+            }
+        }
+    }));
+    consume(distance.back());
+}
+
+// 10^6 values by default, and a graph of n / 4 vertices with 8 edges each
+void benchmark(size_t n) {
+    pushAllPopAll<DaryHeap<uint64_t, 2>>("DaryHeap<2>", n);
+    pushAllPopAll<DaryHeap<uint64_t, 4>>("DaryHeap<4>", n);
+    pushAllPopAll<DaryHeap<uint64_t, 8>>("DaryHeap<8>", n);
+    pushAllPopAll<PairingHeap<uint64_t>>("PairingHeap", n);
+    pushAllPopAll<RadixHeap<uint64_t>>("RadixHeap", n);
+    pushAllPopAll<StdPriorityQueue<uint64_t>>("std::priority_queue", n);
+
+    for (size_t depth : {size_t(1000), n}) {
+        hold<DaryHeap<uint64_t, 4>>("DaryHeap<4>", n, depth);
+        hold<PairingHeap<uint64_t>>("PairingHeap", n, depth);
+        hold<RadixHeap<uint64_t>>("RadixHeap", n, depth);
+        hold<StdPriorityQueue<uint64_t>>("std::priority_queue", n, depth);
+    }
+
+    Graph graph(n / 4, 8);
+    dijkstraLazy<DaryHeap<Entry, 4>>("DaryHeap<4>", graph);
+    dijkstraLazy<PairingHeap<Entry>>("PairingHeap", graph);
+    dijkstraDecreaseKey(graph);
+    dijkstraLazy<RadixHeap<Entry, FirstKey>>("RadixHeap", graph);
+    dijkstraLazy<StdPriorityQueue<Entry>>("std::priority_queue", graph);
+}
+
+int main(int argc, char **argv) {
+    size_t n = benchmarkOps(argc, argv, 1000000);
+    benchmark(n ? n : 1000000);
+    return 0;
+}
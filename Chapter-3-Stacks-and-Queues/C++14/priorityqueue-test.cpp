@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "priorityqueue.hpp"
+
+class PriorityQueueTests : public ::testing::Test {
+public:
+    PriorityQueueTests() = default;
+};
+
+// Random pushes and pops against std::priority_queue. Pushed keys never go below the last
+// popped key, so the same sequence is valid for RadixHeap.
+template<typename Heap>
+void checkAgainstStdPriorityQueue(unsigned spread) {
+    std::mt19937 mt(5);
+    Heap heap;
+    std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> expected;
+    uint64_t last = 0;
+    for (int i = 0; i < 100000; ++i) {
+        if (expected.empty() || mt() % 100 < 55) {
+            uint64_t value = last + mt() % spread;
+            heap.push(value);
+            expected.push(value);
+        } else {
+            ASSERT_EQ(expected.top(), heap.peek());
+            last = heap.pop();
+            ASSERT_EQ(expected.top(), last);
+            expected.pop();
+        }
+        ASSERT_EQ(expected.size(), heap.size());
+    }
+    while (!expected.empty()) {
+        ASSERT_EQ(expected.top(), heap.pop());
+        expected.pop();
+    }
+    ASSERT_TRUE(heap.isEmpty());
+}
+
+TEST_F(PriorityQueueTests, AllHeapsMatchStdPriorityQueue) {
+    for (unsigned spread : {4u, 1000u, 4000000000u}) {
+        checkAgainstStdPriorityQueue<DaryHeap<uint64_t, 2>>(spread);
+        checkAgainstStdPriorityQueue<DaryHeap<uint64_t, 5>>(spread);
+        checkAgainstStdPriorityQueue<PairingHeap<uint64_t>>(spread);
+        checkAgainstStdPriorityQueue<RadixHeap<uint64_t>>(spread);
+    }
+}
+
+// Values carry their handle number, so they are distinct and the heap has to pop the very
+// value the scan finds
+TEST_F(PriorityQueueTests, PairingHeapDecreaseKeyMatchesScan) {
+    using Value = std::pair<long, size_t>;
+    using Heap = PairingHeap<Value>;
+    const Value Popped(LONG_MAX, 0);
+    std::mt19937 mt(6);
+    Heap heap;
+    std::vector<Heap::Handle> handles;
+    std::vector<Value> values;   // value of handles[i], Popped once popped
+    for (int i = 0; i < 30000; ++i) {
+        unsigned action = mt() % 100;
+        if (heap.isEmpty() || action < 40) {
+            values.emplace_back(mt() % 1000000, values.size());
+            handles.push_back(heap.push(values.back()));
+        } else if (action < 80) {
+            size_t h = mt() % handles.size();
+            if (values[h] == Popped)
+                continue;
+            values[h].first -= mt() % 5000;
+            heap.decreaseKey(handles[h], values[h]);
+            ASSERT_EQ(values[h], heap.value(handles[h]));
+        } else {
+            auto minimum = std::min_element(values.begin(), values.end());
+            ASSERT_EQ(*minimum, heap.peek());
+            ASSERT_EQ(*minimum, heap.pop());
+            *minimum = Popped;
+        }
+    }
+    Heap::Handle handle = heap.push(Value(0, 0));
+    ASSERT_THROW(heap.decreaseKey(handle, Value(1, 0)), Heap::KeyIncreasedException);
+}
+
+TEST_F(PriorityQueueTests, RadixHeapIsMonotone) {
+    using Heap = RadixHeap<std::pair<uint64_t, int>, FirstKey>;
+    Heap heap;
+    heap.push(std::make_pair(uint64_t(7), 1));
+    heap.push(std::make_pair(uint64_t(3), 2));
+    heap.push(std::make_pair(uint64_t(UINT64_MAX), 3));
+    heap.push(std::make_pair(uint64_t(3), 4));
+    ASSERT_EQ(3u, heap.pop().first);
+    ASSERT_EQ(3u, heap.lastKey());
+    ASSERT_THROW(heap.push(std::make_pair(uint64_t(2), 5)), Heap::KeyBelowMinimumException);
+    heap.push(std::make_pair(uint64_t(3), 6));
+    ASSERT_EQ(3u, heap.pop().first);
+    ASSERT_EQ(3u, heap.pop().first);
+    ASSERT_EQ(7, static_cast<int>(heap.pop().first));
+    ASSERT_EQ(UINT64_MAX, heap.pop().first);
+    ASSERT_TRUE(heap.isEmpty());
+    ASSERT_THROW(heap.pop(), Heap::HeapIsEmptyException);
+}
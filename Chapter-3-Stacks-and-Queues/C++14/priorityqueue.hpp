@@ -0,0 +1,17 @@
+#pragma once
+
+// Priority queues sharing one interface, all of them min-queues by default:
+//
+//     push(value)     adds a value
+//     peek()          the value that comes first, throws HeapIsEmptyException if empty
+//     pop()           removes and returns that value
+//     isEmpty(), size()
+//
+// DaryHeap      implicit heap in a vector with a tunable arity, the general choice
+// PairingHeap   push returns a handle for decreaseKey, for Dijkstra and Prim without
+//               stale entries
+// RadixHeap     unsigned integer keys that never go below the last popped key
+
+#include "daryheap.hpp"
+#include "pairingheap.hpp"
+#include "radixheap.hpp"
@@ -0,0 +1,78 @@
+// Add/remove storms for the node based Queue, RingQueue and std::deque.
+
+#include <deque>
+#include <iostream>
+#include <vector>
+#include "benchmark.hpp"
+#include "queue.hpp"
+#include "ringqueue.hpp"
+
+// std::deque adapted to the add/peek/remove interface
+struct DequeQueue {
+    void add(int value) {
+        values.push_back(value);
+    }
+
+    int remove() {
+        int value = values.front();
+        values.pop_front();
+        return value;
+    }
+
+    std::deque<int> values;
+};
+
+template<typename Q>
+void fillThenDrain(const std::string &name, size_t ops) {
+    Q queue;
+    reportNsPerOp(name + " fill then drain", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i)
+            queue.add(static_cast<int>(i));
+        for (size_t i = 0; i < ops; ++i)
+            consume(queue.remove());
+    }));
+}
+
+template<typename Q>
+void steadyState(const std::string &name, size_t ops, size_t depth) {
+    Q queue;
+    for (size_t i = 0; i < depth; ++i)
+        queue.add(static_cast<int>(i));
+    reportNsPerOp(name + " steady state, depth " + std::to_string(depth), 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i) {
+            queue.add(static_cast<int>(i));
+            consume(queue.remove());
+        }
+    }));
+}
+
+void bulk(size_t ops, size_t batch) {
+    std::vector<int> values(batch, 1);
+    RingQueue<int> queue;
+    for (int i = 0; i < 1000; ++i)
+        queue.add(i);
+    reportNsPerOp("RingQueue add_n/remove_n, batch " + std::to_string(batch), 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; i += batch) {
+            queue.add_n(values.data(), batch);
+            consume(queue.remove_n(values.data(), batch));
+        }
+    }));
+}
+
+int main(int argc, char **argv) {
+    size_t ops = benchmarkOps(argc, argv, 10000000);
+    if (ops == 0)
+        ops = 10000000;
+
+    fillThenDrain<Queue<int>>("Queue", ops);
+    fillThenDrain<RingQueue<int>>("RingQueue", ops);
+    fillThenDrain<DequeQueue>("std::deque", ops);
+
+    steadyState<Queue<int>>("Queue", ops, 1000);
+    steadyState<RingQueue<int>>("RingQueue", ops, 1000);
+    steadyState<DequeQueue>("std::deque", ops, 1000);
+
+    bulk(ops, 64);
+    bulk(ops, 4096);
+    return 0;
+}
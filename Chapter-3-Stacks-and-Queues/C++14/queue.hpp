@@ -1,3 +1,5 @@
+#pragma once
+
 #include <utility>
 
 template<typename T>
@@ -58,7 +60,8 @@ public:
 
 private:
     struct Node {
-        Node(T &&v) : value(std::move(v)), next(nullptr) {
+        template<typename U>
+        Node(U &&v) : value(std::forward<U>(v)), next(nullptr) {
         }
 
         T value;
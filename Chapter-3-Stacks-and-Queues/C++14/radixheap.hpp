@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Key of a value that is itself an unsigned integer
+struct IdentityKey {
+    template<typename T>
+    uint64_t operator()(const T &value) const {
+        return value;
+    }
+};
+
+// Key of a (key, payload) pair, as pushed by Dijkstra
+struct FirstKey {
+    template<typename T>
+    uint64_t operator()(const T &value) const {
+        return value.first;
+    }
+};
+
+// Monotone priority queue for unsigned integer keys, with the DaryHeap interface. Monotone
+// means no value may be pushed with a key below the last popped key, which holds for
+// Dijkstra and for event simulations.
+//
+// Bucket 0 holds the values whose key equals the last popped key, and bucket b the values
+// whose key first differs from it in bit b - 1. When bucket 0 runs dry, the first
+// non-empty bucket gives the new minimum and its values are spread over lower buckets.
+// A value only moves to a lower bucket, so it is moved at most 64 times and pop is
+// O(log C) amortized for keys up to C, with no comparisons between values.
+template<typename T, typename KeyOf = IdentityKey>
+class RadixHeap {
+public:
+    explicit RadixHeap(KeyOf keyOf = KeyOf()) : keyOf(keyOf), last(0), heapSize(0) {
+    }
+
+    template<typename U>
+    void push(U &&value) {
+        uint64_t key = keyOf(value);
+        if (key < last)
+            throw KeyBelowMinimumException();
+        buckets[bucket(key)].push_back(std::forward<U>(value));
+        ++heapSize;
+    }
+
+    // Not const: it may have to spread a bucket to find the minimum
+    const T &peek() {
+        refill();
+        return buckets[0].back();
+    }
+
+    T pop() {
+        refill();
+        T value = std::move(buckets[0].back());
+        buckets[0].pop_back();
+        --heapSize;
+        return value;
+    }
+
+    bool isEmpty() const {
+        return heapSize == 0;
+    }
+
+    size_t size() const {
+        return heapSize;
+    }
+
+    // Key of the last popped value, the lower bound for push
+    uint64_t lastKey() const {
+        return last;
+    }
+
+    class HeapIsEmptyException {
+    };
+
+    class KeyBelowMinimumException {
+    };
+
+private:
+    static const size_t Buckets = 65;
+
+    size_t bucket(uint64_t key) const {
+        return key == last ? 0 : bitWidth(key ^ last);
+    }
+
+    static size_t bitWidth(uint64_t x) {
+#if defined(__GNUC__)
+        return 64 - __builtin_clzll(x);
+#else
+        size_t width = 0;
+        for (; x != 0; x >>= 1)
+            ++width;
+        return width;
+#endif
+    }
+
+    void refill() {
+        if (!buckets[0].empty())
+            return;
+        if (heapSize == 0)
+            throw HeapIsEmptyException();
+        size_t b = 1;
+        while (buckets[b].empty())
+            ++b;
+        uint64_t minimum = keyOf(buckets[b][0]);
+        for (const T &value : buckets[b]) {
+            if (keyOf(value) < minimum)
+                minimum = keyOf(value);
+        }
+        last = minimum;
+        for (T &value : buckets[b])
+            buckets[bucket(keyOf(value))].push_back(std::move(value));
+        buckets[b].clear();
+    }
+
+    std::vector<T> buckets[Buckets];
+    KeyOf keyOf;
+    uint64_t last;
+    size_t heapSize;
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Queue stored in one contiguous circular buffer. The capacity is always a power of two,
+// so positions wrap with a mask instead of a modulo. When the buffer is full it doubles
+// and the elements are unwrapped to the front of the new buffer; trivially copyable
+// elements are copied with memcpy.
+template<typename T>
+class RingQueue {
+public:
+    RingQueue() : buffer(nullptr), mask(0), head(0), queueSize(0) {
+    }
+
+    explicit RingQueue(size_t initialCapacity) : RingQueue() {
+        reserve(initialCapacity);
+    }
+
+    RingQueue(RingQueue &&other) : buffer(other.buffer), mask(other.mask), head(other.head),
+                                   queueSize(other.queueSize) {
+        other.buffer = nullptr;
+        other.mask = 0;
+        other.head = 0;
+        other.queueSize = 0;
+    }
+
+    ~RingQueue() {
+        for (size_t i = 0; i < queueSize; ++i)
+            slot(head + i)->~T();
+        ::operator delete(buffer);
+    }
+
+    template<typename U>
+    void add(U &&value) {
+        if (queueSize == capacity())
+            reserve(queueSize + 1);
+        new(slot(head + queueSize)) T(std::forward<U>(value));
+        ++queueSize;
+    }
+
+    // Adds n values read from first
+    template<typename InputIt>
+    void add_n(InputIt first, size_t n) {
+        if (n == 0)
+            return;
+        reserve(queueSize + n);
+        addN(first, n, IsMemcpyable<InputIt>());
+        queueSize += n;
+    }
+
+    T &peek() {
+        if (queueSize == 0)
+            throw QueueIsEmptyException();
+        return *slot(head);
+    }
+
+    T remove() {
+        if (queueSize == 0)
+            throw QueueIsEmptyException();
+        T *first = slot(head);
+        auto value(std::move(*first));
+        first->~T();
+        head = (head + 1) & mask;
+        --queueSize;
+        return value;
+    }
+
+    // The most recently added value, so the queue can also serve as a deque
+    T &peekLast() {
+        if (queueSize == 0)
+            throw QueueIsEmptyException();
+        return *slot(head + queueSize - 1);
+    }
+
+    T removeLast() {
+        if (queueSize == 0)
+            throw QueueIsEmptyException();
+        T *last = slot(head + queueSize - 1);
+        auto value(std::move(*last));
+        last->~T();
+        --queueSize;
+        return value;
+    }
+
+    // Moves up to n values into out, returns the number of values removed
+    template<typename OutputIt>
+    size_t remove_n(OutputIt out, size_t n) {
+        if (n > queueSize)
+            n = queueSize;
+        if (n == 0)
+            return 0;
+        removeN(out, n, IsMemcpyable<OutputIt>());
+        head = (head + n) & mask;
+        queueSize -= n;
+        return n;
+    }
+
+    bool isEmpty() const {
+        return queueSize == 0;
+    }
+
+    size_t size() const {
+        return queueSize;
+    }
+
+    size_t capacity() const {
+        return buffer ? mask + 1 : 0;
+    }
+
+    // Grows the buffer to the next power of two holding at least minCapacity values
+    void reserve(size_t minCapacity) {
+        if (minCapacity <= capacity())
+            return;
+        size_t newCapacity = capacity() ? capacity() : 16;
+        while (newCapacity < minCapacity)
+            newCapacity *= 2;
+
+        T *newBuffer = static_cast<T *>(::operator new(newCapacity * sizeof(T)));
+        size_t firstPart = std::min(queueSize, capacity() - head);
+        relocate(buffer + head, firstPart, newBuffer, std::is_trivially_copyable<T>());
+        relocate(buffer, queueSize - firstPart, newBuffer + firstPart, std::is_trivially_copyable<T>());
+        ::operator delete(buffer);
+        buffer = newBuffer;
+        mask = newCapacity - 1;
+        head = 0;
+    }
+
+    class QueueIsEmptyException {
+    };
+
+private:
+    // memcpy is used for trivially copyable values read from or written to raw T pointers
+    template<typename It>
+    using IsMemcpyable = std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                                      std::is_pointer<It>::value &&
+                                                      std::is_same<typename std::remove_cv<
+                                                              typename std::iterator_traits<It>::value_type>::type,
+                                                              T>::value>;
+
+    T *slot(size_t position) {
+        return buffer + (position & mask);
+    }
+
+    static void relocate(T *from, size_t n, T *to, std::true_type) {
+        if (n)
+            std::memcpy(static_cast<void *>(to), from, n * sizeof(T));
+    }
+
+    static void relocate(T *from, size_t n, T *to, std::false_type) {
+        for (size_t i = 0; i < n; ++i) {
+            new(to + i) T(std::move(from[i]));
+            from[i].~T();
+        }
+    }
+
+    template<typename InputIt>
+    void addN(InputIt first, size_t n, std::true_type) {
+        size_t tail = (head + queueSize) & mask;
+        size_t firstPart = std::min(n, capacity() - tail);
+        std::memcpy(static_cast<void *>(buffer + tail), first, firstPart * sizeof(T));
+        std::memcpy(static_cast<void *>(buffer), first + firstPart, (n - firstPart) * sizeof(T));
+    }
+
+    // Destroys what it constructed if a copy throws, so add_n, like add, adds all or nothing
+    template<typename InputIt>
+    void addN(InputIt first, size_t n, std::false_type) {
+        size_t i = 0;
+        try {
+            for (; i < n; ++i, ++first)
+                new(slot(head + queueSize + i)) T(*first);
+        } catch (...) {
+            while (i > 0)
+                slot(head + queueSize + --i)->~T();
+            throw;
+        }
+    }
+
+    template<typename OutputIt>
+    void removeN(OutputIt out, size_t n, std::true_type) {
+        size_t firstPart = std::min(n, capacity() - head);
+        std::memcpy(static_cast<void *>(out), buffer + head, firstPart * sizeof(T));
+        std::memcpy(static_cast<void *>(out + firstPart), buffer, (n - firstPart) * sizeof(T));
+    }
+
+    template<typename OutputIt>
+    void removeN(OutputIt out, size_t n, std::false_type) {
+        for (size_t i = 0; i < n; ++i, ++out) {
+            T *value = slot(head + i);
+            *out = std::move(*value);
+            value->~T();
+        }
+    }
+
+    T *buffer;
+    size_t mask;       // capacity - 1
+    size_t head;       // position of the first value
+    size_t queueSize;
+};
@@ -0,0 +1,145 @@
+// Throughput and hand-off latency of SpscQueue between two threads, against a
+// std::mutex guarded Queue.
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "benchmark.hpp"
+#include "queue.hpp"
+#include "spscqueue.hpp"
+
+// Queue<T> behind a mutex, with the non-blocking SpscQueue interface
+template<typename T>
+class MutexQueue {
+public:
+    template<typename U>
+    bool add(U &&value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.add(std::forward<U>(value));
+        return true;
+    }
+
+    bool remove(T &value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.isEmpty())
+            return false;
+        value = queue.remove();
+        return true;
+    }
+
+    bool isEmpty() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.isEmpty();
+    }
+
+private:
+    std::mutex mutex;
+    Queue<T> queue;
+};
+
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename Q>
+void throughput(const std::string &name, Q &queue, size_t messages) {
+    double ns = timeNs([&] {
+        std::thread producer([&] {
+            for (size_t i = 0; i < messages; ++i) {
+                while (!queue.add(static_cast<int64_t>(i)))
+                    std::this_thread::yield();
+            }
+        });
+        int64_t value;
+        for (size_t received = 0; received < messages;) {
+            if (queue.remove(value)) {
+                consume(value);
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    });
+    reportThroughput(name, messages, ns);
+}
+
+void batchThroughput(size_t messages, size_t batch) {
+    SpscQueue<int64_t> queue(1024);
+    double ns = timeNs([&] {
+        std::thread producer([&] {
+            std::vector<int64_t> values(batch);
+            for (size_t sent = 0; sent < messages;) {
+                size_t n = std::min(batch, messages - sent);
+                for (size_t i = 0; i < n; ++i)
+                    values[i] = static_cast<int64_t>(sent + i);
+                size_t added = 0;
+                while ((added += queue.add_n(values.begin() + added, n - added)) < n)
+                    std::this_thread::yield();
+                sent += n;
+            }
+        });
+        std::vector<int64_t> values(batch);
+        for (size_t received = 0; received < messages;) {
+            size_t n = queue.remove_n(values.begin(), batch);
+            if (n == 0)
+                std::this_thread::yield();
+            received += n;
+        }
+        producer.join();
+    });
+    reportThroughput("SpscQueue batch " + std::to_string(batch), messages, ns);
+}
+
+// The producer sends its clock; with paced = true it waits for the queue to drain first,
+// so only one message is in flight and the sample is the pure hand-off latency.
+template<typename Q>
+void latency(const std::string &name, Q &queue, size_t messages, bool paced) {
+    std::vector<double> samples;
+    samples.reserve(messages);
+    std::thread producer([&] {
+        for (size_t i = 0; i < messages; ++i) {
+            while (paced && !queue.isEmpty())
+                std::this_thread::yield();
+            while (!queue.add(nowNs()))
+                std::this_thread::yield();
+        }
+    });
+    int64_t sent;
+    while (samples.size() < messages) {
+        if (queue.remove(sent))
+            samples.push_back(static_cast<double>(nowNs() - sent));
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    reportPercentiles(name + (paced ? " latency, paced" : " latency, saturated"), samples);
+}
+
+int main(int argc, char **argv) {
+    size_t messages = benchmarkOps(argc, argv, 10000000);
+    if (messages == 0)
+        messages = 10000000;
+
+    {
+        SpscQueue<int64_t> queue(1024);
+        throughput("SpscQueue", queue, messages);
+    }
+    batchThroughput(messages, 32);
+    {
+        MutexQueue<int64_t> queue;
+        throughput("std::mutex + Queue", queue, messages);
+    }
+
+    size_t samples = std::min<size_t>(messages, 1000000);
+    for (bool paced : {true, false}) {
+        SpscQueue<int64_t> spsc(1024);
+        latency("SpscQueue", spsc, samples, paced);
+        MutexQueue<int64_t> locked;
+        latency("std::mutex + Queue", locked, samples, paced);
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "spscqueue.hpp"
+
+class SpscQueueTests : public ::testing::Test {
+public:
+    SpscQueueTests() = default;
+};
+
+TEST_F(SpscQueueTests, CapacityIsRoundedUpToPowerOfTwo) {
+    SpscQueue<int> queue(100);
+    ASSERT_EQ(128, queue.capacity());
+}
+
+TEST_F(SpscQueueTests, AddAndRemoveInOrder) {
+    SpscQueue<int> queue(4);
+    ASSERT_TRUE(queue.isEmpty());
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(queue.add(i));
+    ASSERT_FALSE(queue.add(4));
+    ASSERT_EQ(4, queue.size());
+
+    int value;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.remove(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_FALSE(queue.remove(value));
+    ASSERT_TRUE(queue.isEmpty());
+}
+
+TEST_F(SpscQueueTests, BatchAddStopsWhenFull) {
+    SpscQueue<int> queue(8);
+    std::vector<int> values = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ASSERT_EQ(8, queue.add_n(values.begin(), values.size()));
+
+    std::vector<int> out(10);
+    ASSERT_EQ(5, queue.remove_n(out.begin(), 5));
+    ASSERT_EQ(5, queue.add_n(values.begin() + 5, 5));
+    ASSERT_EQ(0, queue.add_n(values.begin(), 1));
+    ASSERT_EQ(8, queue.remove_n(out.begin(), 10));
+    ASSERT_EQ(5, out[0]);
+    ASSERT_EQ(7, out[2]);
+    ASSERT_EQ(5, out[3]);
+    ASSERT_EQ(9, out[7]);
+}
+
+TEST_F(SpscQueueTests, DestroysRemainingValues) {
+    auto value = std::make_shared<int>(1);
+    {
+        SpscQueue<std::shared_ptr<int>> queue(4);
+        queue.add(value);
+        queue.add(value);
+        ASSERT_EQ(3, value.use_count());
+    }
+    ASSERT_EQ(1, value.use_count());
+}
+
+// One producer and one consumer through a small queue, so the queue keeps wrapping and
+// running full and empty. Every value must arrive exactly once and in order.
+TEST_F(SpscQueueTests, TwoThreadStress) {
+    const int count = 2000000;
+    SpscQueue<int> queue(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            while (!queue.add(i))
+                std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    int value;
+    while (expected < count) {
+        if (queue.remove(value))
+            ASSERT_EQ(expected++, value);
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    ASSERT_TRUE(queue.isEmpty());
+}
+
+TEST_F(SpscQueueTests, TwoThreadBatchStress) {
+    const int count = 2000000;
+    SpscQueue<std::unique_ptr<int>> queue(64);
+
+    std::thread producer([&] {
+        int next = 0;
+        while (next < count) {
+            size_t size = std::min<size_t>(1 + next % 37, count - next);
+            std::vector<std::unique_ptr<int>> values;
+            for (size_t i = 0; i < size; ++i)
+                values.push_back(std::unique_ptr<int>(new int(next + static_cast<int>(i))));
+            size_t added = 0;
+            while (added < size) {
+                added += queue.add_n(std::make_move_iterator(values.begin() + added), size - added);
+                if (added < size)
+                    std::this_thread::yield();
+            }
+            next += static_cast<int>(size);
+        }
+    });
+
+    int expected = 0;
+    std::vector<std::unique_ptr<int>> out(29);
+    while (expected < count) {
+        size_t removed = queue.remove_n(out.begin(), out.size());
+        if (removed == 0)
+            std::this_thread::yield();
+        for (size_t i = 0; i < removed; ++i)
+            ASSERT_EQ(expected++, *out[i]);
+    }
+    producer.join();
+    ASSERT_TRUE(queue.isEmpty());
+}
+
+// size() from a third thread while both sides run must stay within the capacity; read in
+// the wrong order, a head that moved past the tail already read wraps to a huge value.
+TEST_F(SpscQueueTests, SizeFromObserverThread) {
+    const int count = 200000;
+    SpscQueue<int> queue(4);
+    std::atomic<bool> done(false);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            while (!queue.add(i))
+                std::this_thread::yield();
+        }
+    });
+    std::thread consumer([&] {
+        int value;
+        for (int i = 0; i < count;) {
+            if (queue.remove(value))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    size_t largest = 0;
+    while (!done) {
+        largest = std::max(largest, queue.size());
+        std::this_thread::yield();
+    }
+    producer.join();
+    consumer.join();
+    ASSERT_LE(largest, queue.capacity());
+    ASSERT_EQ(0, queue.size());
+}
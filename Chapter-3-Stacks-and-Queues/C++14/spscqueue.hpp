@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Bounded wait-free queue for exactly one producer thread and one consumer thread.
+// The producer only writes tail and the consumer only writes head; each keeps a cached
+// copy of the other side's index and re-reads the shared one only when the cached value
+// says the queue is full (producer) or empty (consumer). The two sides live on separate
+// cache lines so they do not false share.
+template<typename T>
+class SpscQueue {
+public:
+    static constexpr size_t CacheLine = 64;
+
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(size_t minCapacity) : mask(0), head(0), cachedTail(0), tail(0), cachedHead(0) {
+        size_t capacity = 2;
+        while (capacity < minCapacity)
+            capacity *= 2;
+        mask = capacity - 1;
+        buffer = static_cast<T *>(::operator new(capacity * sizeof(T)));
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    ~SpscQueue() {
+        for (size_t i = head.load(std::memory_order_relaxed); i != tail.load(std::memory_order_relaxed); ++i)
+            slot(i)->~T();
+        ::operator delete(buffer);
+    }
+
+    // Producer only. Returns false if the queue is full.
+    template<typename U>
+    bool add(U &&value) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask)
+                return false;
+        }
+        new(slot(t)) T(std::forward<U>(value));
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only. Adds up to n values read from first, returns how many were added.
+    template<typename InputIt>
+    size_t add_n(InputIt first, size_t n) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        size_t space = capacity() - (t - cachedHead);
+        if (space < n) {
+            cachedHead = head.load(std::memory_order_acquire);
+            space = capacity() - (t - cachedHead);
+        }
+        n = std::min(n, space);
+        for (size_t i = 0; i < n; ++i, ++first)
+            new(slot(t + i)) T(*first);
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer only. Returns false if the queue is empty.
+    bool remove(T &value) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail)
+                return false;
+        }
+        T *first = slot(h);
+        value = std::move(*first);
+        first->~T();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Moves up to n values into out, returns how many were removed.
+    template<typename OutputIt>
+    size_t remove_n(OutputIt out, size_t n) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (cachedTail - h < n)
+            cachedTail = tail.load(std::memory_order_acquire);
+        n = std::min(n, cachedTail - h);
+        for (size_t i = 0; i < n; ++i, ++out) {
+            T *value = slot(h + i);
+            *out = std::move(*value);
+            value->~T();
+        }
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    // Exact only when called from the producer or the consumer while the other side is idle
+    bool isEmpty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    // Safe from any thread. head is read first: tail is never behind head and only grows, so
+    // the difference cannot wrap. The consumer can move on between the two loads and let the
+    // producer add more than capacity() past the head read here, hence the clamp.
+    size_t size() const {
+        const size_t h = head.load(std::memory_order_acquire);
+        const size_t t = tail.load(std::memory_order_acquire);
+        return std::min(t - h, capacity());
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    T *slot(size_t position) {
+        return buffer + (position & mask);
+    }
+
+    // read-only after construction
+    alignas(CacheLine) T *buffer;
+    size_t mask;
+
+    // consumer side
+    alignas(CacheLine) std::atomic<size_t> head;
+    size_t cachedTail;
+
+    // producer side
+    alignas(CacheLine) std::atomic<size_t> tail;
+    size_t cachedHead;
+};
@@ -0,0 +1,83 @@
+// Push/pop storms for Stack against std::stack (std::deque) and std::vector.
+
+#include <iostream>
+#include <stack>
+#include <vector>
+#include "benchmark.hpp"
+#include "stack.hpp"
+
+template<typename S>
+void fillThenDrain(const std::string &name, size_t ops) {
+    S stack;
+    reportNsPerOp(name + " fill then drain", 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i)
+            stack.push(static_cast<int>(i));
+        for (size_t i = 0; i < ops; ++i) {
+            consume(stack.top());
+            stack.pop();
+        }
+    }));
+}
+
+template<typename S>
+void sawtooth(const std::string &name, size_t ops, size_t depth) {
+    S stack;
+    for (size_t i = 0; i < depth; ++i)
+        stack.push(static_cast<int>(i));
+    reportNsPerOp(name + " sawtooth at depth " + std::to_string(depth), 2 * ops, timeNs([&] {
+        for (size_t i = 0; i < ops; ++i) {
+            stack.push(static_cast<int>(i));
+            consume(stack.top());
+            stack.pop();
+        }
+    }));
+}
+
+// Stack::pop returns the value, adapt it to the std::stack interface
+struct ChunkedStack {
+    void push(int value) {
+        stack.push(value);
+    }
+
+    int top() {
+        return stack.peek();
+    }
+
+    void pop() {
+        stack.pop();
+    }
+
+    Stack<int> stack;
+};
+
+struct VectorStack {
+    void push(int value) {
+        values.push_back(value);
+    }
+
+    int top() {
+        return values.back();
+    }
+
+    void pop() {
+        values.pop_back();
+    }
+
+    std::vector<int> values;
+};
+
+int main(int argc, char **argv) {
+    size_t ops = benchmarkOps(argc, argv, 10000000);
+    if (ops == 0)
+        ops = 10000000;
+
+    fillThenDrain<ChunkedStack>("Stack", ops);
+    fillThenDrain<std::stack<int>>("std::stack", ops);
+    fillThenDrain<VectorStack>("std::vector", ops);
+
+    // 1024 ints fill exactly one chunk of Stack<int>, the sawtooth crosses the boundary
+    sawtooth<ChunkedStack>("Stack", ops, 1024);
+    sawtooth<std::stack<int>>("std::stack", ops, 1024);
+    sawtooth<VectorStack>("std::vector", ops, 1024);
+    return 0;
+}
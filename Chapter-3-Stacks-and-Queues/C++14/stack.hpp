@@ -1,40 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
 #include <utility>
 
-template<typename T>
+// Elements are stored in a chain of fixed-size chunks instead of one heap node per element.
+// A chunk that becomes empty is kept as a spare, so pushing and popping around a chunk
+// boundary does not allocate and free a chunk every time.
+template<typename T, size_t ChunkCapacity = (sizeof(T) < 512 ? 4096 / sizeof(T) : 8)>
 class Stack {
 public:
-    Stack() : top(nullptr), stackSize(0) {
+    static_assert(ChunkCapacity > 0, "ChunkCapacity must be positive");
+
+    Stack() : top(nullptr), spare(nullptr), topCount(0), stackSize(0) {
     }
 
-    Stack(Stack &&other) : top(std::move(other.top)), stackSize(std::move(other.stackSize)) {
+    Stack(Stack &&other) : top(other.top), spare(other.spare), topCount(other.topCount),
+                           stackSize(other.stackSize) {
+        other.top = nullptr;
+        other.spare = nullptr;
+        other.topCount = 0;
+        other.stackSize = 0;
     }
 
     ~Stack() {
-        while (!isEmpty())
-            pop();
+        while (top) {
+            for (size_t i = 0; i < topCount; ++i)
+                top->slot(i)->~T();
+            auto chunk = top;
+            top = chunk->prev;
+            topCount = ChunkCapacity;
+            delete chunk;
+        }
+        delete spare;
     }
 
     template<typename U>
     void push(U &&value) {
-        auto n = new Node(std::forward<U>(value), top);
-        top = n;
+        bool newChunk = !top || topCount == ChunkCapacity;
+        if (newChunk)
+            pushChunk();
+        try {
+            new(top->slot(topCount)) T(std::forward<U>(value));
+        } catch (...) {
+            // an empty top chunk would make peek and pop read the slot before it
+            if (newChunk)
+                popChunk();
+            throw;
+        }
+        ++topCount;
         ++stackSize;
     }
 
     T &peek() {
         if (!top)
             throw StackIsEmptyException();
-        return top->value;
+        return *top->slot(topCount - 1);
     }
 
     T pop() {
         if (!top)
             throw StackIsEmptyException();
-        auto value(std::move(top->value));
-        auto n = top;
-        top = n->next;
-        delete n;
+        T *slot = top->slot(topCount - 1);
+        auto value(std::move(*slot));
+        slot->~T();
         --stackSize;
+        if (--topCount == 0)
+            popChunk();
         return value;
     }
 
@@ -50,17 +82,75 @@ public:
     };
 
 private:
-    struct Node {
-        Node(T &&v, Node *n) : value(std::move(v)), next(n) {
+    struct Chunk;
+
+public:
+    // Reads the values from the top down without removing them. Values never move, so a
+    // push does not invalidate a cursor, and neither does popping values it has passed.
+    class Cursor {
+    public:
+        bool done() const {
+            return remaining == 0;
+        }
+
+        const T &value() const {
+            return *chunk->slot(index);
+        }
+
+        void next() {
+            if (index == 0) {
+                chunk = chunk->prev;
+                index = ChunkCapacity;
+            }
+            --index;
+            --remaining;
+        }
+
+    private:
+        friend class Stack;
+
+        Cursor(Chunk *chunk, size_t index, size_t remaining) : chunk(chunk), index(index), remaining(remaining) {
         }
 
-        Node(const T &v, Node *n) : value(v), next(n) {
+        Chunk *chunk;
+        size_t index;
+        size_t remaining;
+    };
+
+    Cursor fromTop() const {
+        return Cursor(top, topCount ? topCount - 1 : 0, stackSize);
+    }
+
+private:
+    struct Chunk {
+        T *slot(size_t i) {
+            return reinterpret_cast<T *>(storage) + i;
         }
 
-        T value;
-        Node *next;
+        Chunk *prev;
+        alignas(T) unsigned char storage[ChunkCapacity * sizeof(T)];
     };
 
-    Node *top;
+    void pushChunk() {
+        Chunk *chunk = spare ? spare : new Chunk;
+        spare = nullptr;
+        chunk->prev = top;
+        top = chunk;
+        topCount = 0;
+    }
+
+    void popChunk() {
+        Chunk *chunk = top;
+        top = chunk->prev;
+        topCount = top ? ChunkCapacity : 0;
+        if (spare)
+            delete chunk;
+        else
+            spare = chunk;
+    }
+
+    Chunk *top;        // chunk holding the top element, nullptr if the stack is empty
+    Chunk *spare;      // one empty chunk kept for the next push
+    size_t topCount;   // number of elements in the top chunk
     size_t stackSize;
 };
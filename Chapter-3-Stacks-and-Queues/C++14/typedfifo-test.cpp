@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include <deque>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+#include "typedfifo.hpp"
+
+class TypedFifoTests : public ::testing::Test {
+public:
+    TypedFifoTests() = default;
+};
+
+enum class Colour {
+    Red,
+    Green,
+    Blue,
+    Count
+};
+
+using ColourFifo = TypedFifo<Colour, int>;
+using WideFifo = TypedFifo<size_t, int, 37>;
+
+TEST_F(TypedFifoTests, EnumCategoriesKeepArrivalOrder) {
+    ColourFifo fifo;
+    fifo.enqueue(Colour::Blue, 1);
+    fifo.enqueue(Colour::Red, 2);
+    fifo.enqueue(Colour::Blue, 3);
+    fifo.enqueue(Colour::Green, 4);
+    ASSERT_EQ(4u, fifo.size());
+    ASSERT_EQ(2u, fifo.size(Colour::Blue));
+
+    ASSERT_EQ(Colour::Blue, fifo.peekAnyCategory());
+    ASSERT_EQ(1, fifo.dequeueAny());
+    ASSERT_EQ(4, fifo.dequeue(Colour::Green));
+    ASSERT_EQ(2, fifo.dequeueAny());
+    ASSERT_TRUE(fifo.isEmpty(Colour::Red));
+    ASSERT_THROW(fifo.dequeue(Colour::Red), ColourFifo::QueueIsEmptyException);
+    ASSERT_EQ(3, fifo.dequeueAny());
+    ASSERT_TRUE(fifo.isEmpty());
+    ASSERT_THROW(fifo.dequeueAny(), ColourFifo::QueueIsEmptyException);
+}
+
+// Random enqueues, dequeues of one category, single and batch dequeueAny against one
+// deque in arrival order, where dequeue of a category takes its first value in the deque
+TEST_F(TypedFifoTests, ManyCategoriesMatchOneDeque) {
+    std::mt19937 mt(3);
+    WideFifo fifo;
+    std::deque<std::pair<size_t, int>> expected;
+    int next = 0;
+    for (int i = 0; i < 200000; ++i) {
+        unsigned action = mt() % 100;
+        if (expected.empty() || action < 50) {
+            size_t category = mt() % 8 == 0 ? mt() % 37 : mt() % 5;
+            size_t run = 1 + mt() % 4;
+            for (size_t j = 0; j < run; ++j) {
+                fifo.enqueue(category, next);
+                expected.emplace_back(category, next++);
+            }
+        } else if (action < 70) {
+            size_t category = mt() % 37;
+            auto it = expected.begin();
+            while (it != expected.end() && it->first != category)
+                ++it;
+            if (it == expected.end()) {
+                ASSERT_TRUE(fifo.isEmpty(category));
+                continue;
+            }
+            ASSERT_EQ(it->second, fifo.dequeue(category));
+            expected.erase(it);
+        } else if (action < 90) {
+            ASSERT_EQ(expected.front().first, fifo.peekAnyCategory());
+            ASSERT_EQ(expected.front().second, fifo.dequeueAny());
+            expected.pop_front();
+        } else {
+            std::vector<int> batch;
+            size_t n = mt() % 20;
+            ASSERT_EQ(std::min(n, expected.size()), fifo.dequeueAny_n(std::back_inserter(batch), n));
+            for (int value : batch) {
+                ASSERT_EQ(expected.front().second, value);
+                expected.pop_front();
+            }
+        }
+        ASSERT_EQ(expected.size(), fifo.size());
+    }
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "ringqueue.hpp"
+
+// FIFO of values tagged with one of NumCategories categories, from an enum whose values
+// are 0 .. NumCategories - 1 (by default up to its Count value). Every category keeps its
+// values in its own RingQueue together with their global arrival number, so dequeue of a
+// category is a ring buffer pop and no value is looked at through RTTI.
+//
+// dequeueAny takes the oldest value of all categories. The non-empty categories sit in a
+// binary heap keyed by the arrival number of their front value. A category that becomes
+// non-empty holds the newest value, so it is appended without sifting; taking a front
+// value only makes its category's key larger, so it is one sift down, O(log K).
+template<typename Category, typename T, size_t NumCategories = static_cast<size_t>(Category::Count)>
+class TypedFifo {
+public:
+    static_assert(NumCategories > 0, "TypedFifo needs at least one category");
+
+    TypedFifo() : nextArrival(0), heapSize(0), fifoSize(0) {
+        for (size_t i = 0; i < NumCategories; ++i)
+            position[i] = NotInHeap;
+    }
+
+    template<typename U>
+    void enqueue(Category category, U &&value) {
+        size_t c = index(category);
+        queues[c].add(Entry{nextArrival++, std::forward<U>(value)});
+        if (position[c] == NotInHeap)
+            place(heapSize++, Front{nextArrival - 1, c});
+        ++fifoSize;
+    }
+
+    // Oldest value of one category
+    T dequeue(Category category) {
+        size_t c = index(category);
+        if (queues[c].isEmpty())
+            throw QueueIsEmptyException();
+        T value = std::move(queues[c].remove().value);
+        frontChanged(c);
+        --fifoSize;
+        return value;
+    }
+
+    // Oldest value of all categories
+    T dequeueAny() {
+        if (heapSize == 0)
+            throw QueueIsEmptyException();
+        return dequeue(static_cast<Category>(heap[0].category));
+    }
+
+    // Category of the value dequeueAny would return
+    Category peekAnyCategory() const {
+        if (heapSize == 0)
+            throw QueueIsEmptyException();
+        return static_cast<Category>(heap[0].category);
+    }
+
+    // Moves up to n of the oldest values, in arrival order, into out and returns how many
+    // were moved. Values of one category that are older than every other category's front
+    // are taken as one run, so the heap is only fixed once per run.
+    template<typename OutputIt>
+    size_t dequeueAny_n(OutputIt out, size_t n) {
+        size_t taken = 0;
+        while (taken < n && heapSize > 0) {
+            size_t c = heap[0].category;
+            uint64_t limit = secondOldestFront();
+            RingQueue<Entry> &queue = queues[c];
+            do {
+                *out = std::move(queue.remove().value);
+                ++out;
+                ++taken;
+            } while (taken < n && !queue.isEmpty() && queue.peek().arrival < limit);
+            frontChanged(c);
+        }
+        fifoSize -= taken;
+        return taken;
+    }
+
+    bool isEmpty() const {
+        return fifoSize == 0;
+    }
+
+    bool isEmpty(Category category) const {
+        return queues[index(category)].isEmpty();
+    }
+
+    size_t size() const {
+        return fifoSize;
+    }
+
+    size_t size(Category category) const {
+        return queues[index(category)].size();
+    }
+
+    class QueueIsEmptyException {
+    };
+
+private:
+    struct Entry {
+        uint64_t arrival;
+        T value;
+    };
+
+    // Key of a non-empty category in the heap, copied so sifting stays inside the heap array
+    struct Front {
+        uint64_t arrival;
+        size_t category;
+    };
+
+    static const size_t NotInHeap = static_cast<size_t>(-1);
+
+    static size_t index(Category category) {
+        return static_cast<size_t>(category);
+    }
+
+    // Arrival number of the oldest front value outside the heap root's category
+    uint64_t secondOldestFront() const {
+        uint64_t limit = UINT64_MAX;
+        if (heapSize > 1)
+            limit = heap[1].arrival;
+        if (NumCategories > 2 && heapSize > 2 && heap[2].arrival < limit)
+            limit = heap[2].arrival;
+        return limit;
+    }
+
+    // Category c lost its front value: its key grew or it became empty
+    void frontChanged(size_t c) {
+        size_t i = position[c];
+        if (queues[c].isEmpty()) {
+            position[c] = NotInHeap;
+            if (i == --heapSize)
+                return;
+            Front last = heap[heapSize];
+            siftUp(i, last);
+            siftDown(position[last.category], last);
+        } else
+            siftDown(i, Front{queues[c].peek().arrival, c});
+    }
+
+    // Fills the hole at i with front, moving parents down while they are newer
+    void siftUp(size_t i, Front front) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (heap[parent].arrival < front.arrival)
+                break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, front);
+    }
+
+    // Fills the hole at i with front, moving the older child up while it is older
+    void siftDown(size_t i, Front front) {
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= heapSize)
+                break;
+            if (child + 1 < heapSize && heap[child + 1].arrival < heap[child].arrival)
+                ++child;
+            if (front.arrival < heap[child].arrival)
+                break;
+            place(i, heap[child]);
+            i = child;
+        }
+        place(i, front);
+    }
+
+    void place(size_t i, Front front) {
+        heap[i] = front;
+        position[front.category] = i;
+    }
+
+    RingQueue<Entry> queues[NumCategories];
+    Front heap[NumCategories];        // non-empty categories, oldest front value first
+    size_t position[NumCategories];   // index of each category in heap, NotInHeap if empty
+    uint64_t nextArrival;
+    size_t heapSize;
+    size_t fifoSize;
+};
@@ -0,0 +1,224 @@
+// Fork-join benchmark for WorkStealingDeque: parallel fib and a binary tree sum on a small
+// work-stealing pool, against the same recursion run sequentially.
+//
+// Usage: workstealingdeque-benchmark --benchmark [n]   computes fib(n), default 32
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "benchmark.hpp"
+#include "workstealingdeque.hpp"
+
+struct Task {
+    virtual ~Task() = default;
+
+    virtual void run() = 0;
+
+    std::atomic<bool> done{false};
+};
+
+// Every worker owns a deque. spawn pushes onto the caller's deque; join runs other work
+// until the task is done: first the caller's own deque, then tasks stolen from a random
+// victim. The thread that calls invoke is worker 0.
+class ForkJoinPool {
+public:
+    explicit ForkJoinPool(unsigned workers) : stop(false) {
+        for (unsigned i = 0; i < workers; ++i)
+            deques.emplace_back(new WorkStealingDeque<Task *>(256));
+        for (unsigned i = 1; i < workers; ++i) {
+            threads.emplace_back([this, i] {
+                workerIndex() = i;
+                while (!stop.load(std::memory_order_acquire)) {
+                    if (!runOne(i))
+                        std::this_thread::yield();
+                }
+            });
+        }
+    }
+
+    ~ForkJoinPool() {
+        stop.store(true, std::memory_order_release);
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    void invoke(Task &root) {
+        workerIndex() = 0;
+        root.run();
+    }
+
+    void spawn(Task &task) {
+        deques[workerIndex()]->push(&task);
+    }
+
+    void join(Task &task) {
+        unsigned self = workerIndex();
+        while (!task.done.load(std::memory_order_acquire))
+            runOne(self);
+    }
+
+private:
+    static unsigned &workerIndex() {
+        static thread_local unsigned index = 0;
+        return index;
+    }
+
+    bool runOne(unsigned self) {
+        Task *task;
+        if (!deques[self]->pop(task) && !stealOne(self, task))
+            return false;
+        task->run();
+        task->done.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool stealOne(unsigned self, Task *&task) {
+        static thread_local uint32_t seed = 2463534242u + self;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        size_t n = deques.size();
+        for (size_t i = 0; i < n; ++i) {
+            size_t victim = (seed + i) % n;
+            if (victim != self && deques[victim]->steal(task))
+                return true;
+        }
+        return false;
+    }
+
+    std::vector<std::unique_ptr<WorkStealingDeque<Task *>>> deques;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stop;
+};
+
+static const int FibCutoff = 16;
+
+static int64_t fib(int n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+struct FibTask : Task {
+    FibTask(ForkJoinPool &pool, int n) : pool(pool), n(n), result(0) {
+    }
+
+    void run() override {
+        if (n < FibCutoff) {
+            result = fib(n);
+            return;
+        }
+        FibTask first(pool, n - 1), second(pool, n - 2);
+        pool.spawn(second);
+        first.run();
+        pool.join(second);
+        result = first.result + second.result;
+    }
+
+    ForkJoinPool &pool;
+    int n;
+    int64_t result;
+};
+
+struct TreeNode {
+    int64_t value;
+    TreeNode *left;
+    TreeNode *right;
+};
+
+static const int TreeSumCutoff = 12;   // subtrees of this height or less are summed sequentially
+
+static int64_t treeSum(const TreeNode *node) {
+    return node ? node->value + treeSum(node->left) + treeSum(node->right) : 0;
+}
+
+struct TreeSumTask : Task {
+    TreeSumTask(ForkJoinPool &pool, const TreeNode *node, int height) : pool(pool), node(node), height(height),
+                                                                      result(0) {
+    }
+
+    void run() override {
+        if (height <= TreeSumCutoff) {
+            result = treeSum(node);
+            return;
+        }
+        TreeSumTask left(pool, node->left, height - 1), right(pool, node->right, height - 1);
+        pool.spawn(right);
+        left.run();
+        pool.join(right);
+        result = node->value + left.result + right.result;
+    }
+
+    ForkJoinPool &pool;
+    const TreeNode *node;
+    int height;
+    int64_t result;
+};
+
+// Perfect binary tree of the given height whose nodes are allocated in a shuffled order,
+// so neighbouring nodes are not neighbours in memory. The root is nodes[0].
+static std::vector<TreeNode> buildTree(int height) {
+    size_t size = (size_t(1) << height) - 1;
+    std::vector<size_t> place(size);
+    for (size_t i = 0; i < size; ++i)
+        place[i] = i;
+    uint64_t seed = 88172645463325252ull;
+    for (size_t i = size - 1; i > 0; --i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        std::swap(place[i], place[seed % (i + 1)]);
+    }
+    std::swap(place[0], *std::find(place.begin(), place.end(), 0));   // root stays at nodes[0]
+    std::vector<TreeNode> nodes(size);
+    for (size_t i = 0; i < size; ++i) {
+        TreeNode &node = nodes[place[i]];
+        node.value = static_cast<int64_t>(i % 1000);
+        node.left = 2 * i + 1 < size ? &nodes[place[2 * i + 1]] : nullptr;
+        node.right = 2 * i + 2 < size ? &nodes[place[2 * i + 2]] : nullptr;
+    }
+    return nodes;
+}
+
+int main(int argc, char **argv) {
+    size_t n = benchmarkOps(argc, argv, 32);
+    if (n == 0)
+        n = 32;
+    const int fibN = static_cast<int>(n);
+    const int treeHeight = 22;
+
+    std::vector<unsigned> workerCounts = {1, 2, 4};
+    unsigned hardware = std::thread::hardware_concurrency();
+    if (hardware > 4)
+        workerCounts.push_back(hardware);
+
+    // number of calls made by the plain recursion, used as the op count
+    size_t fibCalls = static_cast<size_t>(2 * fib(fibN + 1) - 1);
+    int64_t expected = 0;
+    double ns = timeNs([&] { expected = fib(fibN); });
+    consume(expected);
+    reportNsPerOp("fib(" + std::to_string(fibN) + ") sequential", fibCalls, ns);
+    for (unsigned workers : workerCounts) {
+        ForkJoinPool pool(workers);
+        FibTask root(pool, fibN);
+        ns = timeNs([&] { pool.invoke(root); });
+        if (root.result != expected)
+            std::cout << "wrong result " << root.result << std::endl;
+        reportNsPerOp("fib(" + std::to_string(fibN) + ") " + std::to_string(workers) + " workers", fibCalls, ns);
+    }
+
+    std::vector<TreeNode> tree = buildTree(treeHeight);
+    ns = timeNs([&] { expected = treeSum(&tree[0]); });
+    consume(expected);
+    reportNsPerOp("tree sum sequential", tree.size(), ns);
+    for (unsigned workers : workerCounts) {
+        ForkJoinPool pool(workers);
+        TreeSumTask root(pool, &tree[0], treeHeight);
+        ns = timeNs([&] { pool.invoke(root); });
+        if (root.result != expected)
+            std::cout << "wrong result " << root.result << std::endl;
+        reportNsPerOp("tree sum " + std::to_string(workers) + " workers", tree.size(), ns);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "workstealingdeque.hpp"
+
+class WorkStealingDequeTests : public ::testing::Test {
+public:
+    WorkStealingDequeTests() = default;
+};
+
+TEST_F(WorkStealingDequeTests, PopIsLifoStealIsFifo) {
+    WorkStealingDeque<int> deque(4);
+    for (int i = 0; i < 5; ++i)
+        deque.push(i);
+    ASSERT_EQ(5, deque.size());
+
+    int value;
+    ASSERT_TRUE(deque.pop(value));
+    ASSERT_EQ(4, value);
+    ASSERT_TRUE(deque.steal(value));
+    ASSERT_EQ(0, value);
+    ASSERT_TRUE(deque.steal(value));
+    ASSERT_EQ(1, value);
+    ASSERT_TRUE(deque.pop(value));
+    ASSERT_EQ(3, value);
+    ASSERT_TRUE(deque.pop(value));
+    ASSERT_EQ(2, value);
+    ASSERT_FALSE(deque.pop(value));
+    ASSERT_FALSE(deque.steal(value));
+    ASSERT_TRUE(deque.isEmpty());
+}
+
+TEST_F(WorkStealingDequeTests, GrowsWhileWrapped) {
+    WorkStealingDeque<int> deque(4);
+    int value;
+    for (int i = 0; i < 3; ++i)
+        deque.push(i);
+    ASSERT_TRUE(deque.steal(value));
+    ASSERT_TRUE(deque.steal(value));
+    for (int i = 3; i < 20; ++i)
+        deque.push(i);
+    ASSERT_EQ(32, deque.capacity());
+    for (int i = 2; i < 20; ++i) {
+        ASSERT_TRUE(deque.steal(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_TRUE(deque.isEmpty());
+}
+
+// The owner pushes every value once and pops some of them back while thieves steal from
+// a deque that starts small, so it grows under contention. Each value must be taken by
+// exactly one thread.
+TEST_F(WorkStealingDequeTests, NoValueLostOrDuplicated) {
+    const int count = 1000000;
+    const int thieves = 3;
+    WorkStealingDeque<int> deque(2);
+    std::vector<std::atomic<int>> taken(count);
+    for (auto &times : taken)
+        times.store(0);
+    std::atomic<int> takenTotal(0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thieves; ++i) {
+        threads.emplace_back([&] {
+            int value;
+            while (takenTotal.load() < count) {
+                if (deque.steal(value)) {
+                    taken[value].fetch_add(1);
+                    takenTotal.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    int value;
+    for (int i = 0; i < count; ++i) {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(value)) {
+            taken[value].fetch_add(1);
+            takenTotal.fetch_add(1);
+        }
+    }
+    while (deque.pop(value)) {
+        taken[value].fetch_add(1);
+        takenTotal.fetch_add(1);
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_EQ(count, takenTotal.load());
+    for (int i = 0; i < count; ++i)
+        ASSERT_EQ(1, taken[i].load()) << "value " << i;
+}
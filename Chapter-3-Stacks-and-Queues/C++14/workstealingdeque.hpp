@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev work-stealing deque, with the memory orderings of Lê, Pop, Cohen and Zappa
+// Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+//
+// The owning thread uses it as a stack: push and pop work on the bottom end. Any other
+// thread may steal from the top end, so thieves take the oldest work, which in fork-join
+// code is usually the largest piece. Only pop of the last element and steal need a CAS.
+//
+// The circular array doubles when full. Thieves may still be reading an old array, so
+// arrays that were replaced are kept until the deque is destroyed. Values are copied
+// out of a slot before the CAS that claims them, so T must be trivially copyable;
+// store pointers to tasks, not the tasks themselves.
+template<typename T>
+class WorkStealingDeque {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque needs a trivially copyable T");
+
+    static constexpr size_t CacheLine = 64;
+
+    // Capacity is rounded up to a power of two
+    explicit WorkStealingDeque(size_t initialCapacity = 64) : top(0), bottom(0) {
+        size_t capacity = 2;
+        while (capacity < initialCapacity)
+            capacity *= 2;
+        array.store(new Array(capacity), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    ~WorkStealingDeque() {
+        delete array.load(std::memory_order_relaxed);
+        for (Array *old : retired)
+            delete old;
+    }
+
+    // Owner only
+    void push(T value) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array *a = array.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(a->mask))
+            a = grow(a, t, b);
+        a->put(b, value);
+        // the paper uses a release fence and a relaxed store; a release store publishes the
+        // value just as well and ThreadSanitizer understands it
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only. Takes the most recently pushed value, returns false if the deque is empty.
+    bool pop(T &value) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        value = a->get(b);
+        if (t == b) {
+            // last element, race the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Takes the oldest value, returns false if the deque is empty or another
+    // thread took that value first.
+    bool steal(T &value) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        Array *a = array.load(std::memory_order_acquire);
+        T stolen = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+        value = stolen;
+        return true;
+    }
+
+    // Only a snapshot while other threads are stealing
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return array.load(std::memory_order_relaxed)->mask + 1;
+    }
+
+private:
+    struct Array {
+        explicit Array(size_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {
+        }
+
+        ~Array() {
+            delete[] slots;
+        }
+
+        T get(int64_t position) const {
+            return slots[position & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t position, T value) {
+            slots[position & mask].store(value, std::memory_order_relaxed);
+        }
+
+        size_t mask;
+        std::atomic<T> *slots;
+    };
+
+    Array *grow(Array *old, int64_t t, int64_t b) {
+        Array *bigger = new Array(2 * (old->mask + 1));
+        for (int64_t i = t; i < b; ++i)
+            bigger->put(i, old->get(i));
+        retired.push_back(old);
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // Padding rather than alignas keeps top and bottom on separate cache lines, because a
+    // pool allocates its deques with new, which ignores extended alignment before C++17.
+    char padBefore[CacheLine];
+
+    // written by thieves and by the owner when taking the last element
+    std::atomic<int64_t> top;
+    char padTop[CacheLine - sizeof(std::atomic<int64_t>)];
+
+    // owner side
+    std::atomic<int64_t> bottom;
+    std::atomic<Array *> array;
+    std::vector<Array *> retired;
+};
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "BPlusTree.h"
+
+class BPlusTreeTests : public ::testing::Test {
+public:
+    BPlusTreeTests() = default;
+
+    /**
+     * @brief random inserts and removes against std::set. Small nodes split and merge at
+     * every few operations.
+     */
+    template<typename Tree>
+    static void checkAgainstSet(int range, int operations) {
+        std::mt19937 generator(3);
+        Tree tree;
+        std::set<int> expected;
+        for (int i = 0; i < operations; i++) {
+            int x = static_cast<int>(generator() % range);
+            if (generator() % 2 == 0) {
+                tree.remove(x);
+                expected.erase(x);
+            } else {
+                tree.insert(x);
+                expected.insert(x);
+            }
+            ASSERT_EQ(expected.count(x) == 1, tree.contains(x));
+            ASSERT_EQ(expected.size(), tree.size());
+            ASSERT_EQ(expected.empty(), tree.empty());
+            if (!expected.empty()) {
+                ASSERT_EQ(*expected.begin(), tree.findMin());
+                ASSERT_EQ(*expected.rbegin(), tree.findMax());
+            }
+        }
+        std::vector<int> scanned;
+        tree.for_each_in_range(0, range, [&scanned](int x) {
+            scanned.push_back(x);
+        });
+        ASSERT_EQ(std::vector<int>(expected.begin(), expected.end()), scanned);
+    }
+};
+
+TEST_F(BPlusTreeTests, MatchesSet) {
+    checkAgainstSet<BPlusTree<int, std::less<int>, 64>>(500, 50000);
+    checkAgainstSet<BPlusTree<int, std::less<int>, 64>>(20000, 50000);
+    checkAgainstSet<BPlusTree<int>>(20000, 50000);
+}
+
+TEST_F(BPlusTreeTests, RangeScan) {
+    BPlusTree<std::string> tree;
+    for (int i = 0; i < 1000; i++) {
+        tree.insert(std::to_string(i));
+    }
+    std::vector<std::string> scanned;
+    tree.for_each_in_range("10", "11", [&scanned](const std::string &x) {
+        scanned.push_back(x);
+    });
+    std::vector<std::string> expected{"10", "100", "101", "102", "103", "104", "105", "106", "107", "108", "109",
+                                      "11"};
+    ASSERT_EQ(expected, scanned);
+
+    for (int i = 0; i < 1000; i++) {
+        tree.remove(std::to_string(i));
+    }
+    ASSERT_TRUE(tree.empty());
+    tree.insert("x");
+    ASSERT_EQ("x", tree.findMin());
+}
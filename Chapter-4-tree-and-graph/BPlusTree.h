@@ -0,0 +1,412 @@
+/**
+ * A B+-tree with the BinarySearchTree interface.
+ */
+
+#ifndef CRACKINGTHECODINGINTERVIEW_BPLUSTREE_H
+#define CRACKINGTHECODINGINTERVIEW_BPLUSTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief an ordered set whose nodes are whole cache lines
+ * @details a binary tree pays a cache miss for every level, about log2(n) of them. Here a
+ * node holds as many keys as fit in NodeBytes, rounded up to a multiple of 64 bytes, and
+ * searching a node only touches those lines, so a lookup is log_B(n) misses for B keys
+ * per node: 3 or 4 levels for 10^7 ints instead of 24.
+ *
+ * The elements are all in the leaves, which are linked in order for range scans. Inner
+ * nodes only hold separators: keys[i] is the smallest key of children[i + 1], or was when
+ * it was set. Every node except the root is at least half full. Nodes have one spare slot,
+ * so a full node takes the new key first and is then split in two.
+ *
+ * Object must be default constructible and move assignable, since nodes are arrays of
+ * them. A duplicate insert is ignored, as in std::set. The tree is not copyable.
+ */
+template<typename Object, typename Comparator=std::less<Object>, std::size_t NodeBytes=256>
+class BPlusTree {
+public:
+
+    BPlusTree() = default;
+
+    BPlusTree(const BPlusTree &) = delete;
+
+    BPlusTree &operator=(const BPlusTree &) = delete;
+
+    ~BPlusTree() {
+        makeEmpty();
+    }
+
+    const Object &findMin() const {
+        return head->keys[0];
+    }
+
+    const Object &findMax() const {
+        return tail->keys[tail->count - 1];
+    }
+
+    bool contains(const Object &x) const {
+        if (root == nullptr) {
+            return false;
+        }
+        const Leaf *leaf = findLeaf(x);
+        std::size_t i = lowerBound(leaf, x);
+        return i < leaf->count && !comparator(x, leaf->keys[i]);
+    }
+
+    bool empty() const {
+        return root == nullptr;
+    }
+
+    std::size_t size() const {
+        return keyCount;
+    }
+
+    void insert(const Object &x) {
+        insertKey(x);
+    }
+
+    void insert(Object &&x) {
+        insertKey(std::move(x));
+    }
+
+    /**
+     * @details the key leaves its leaf. A leaf left less than half full borrows a key from
+     * a sibling that can spare one, or else is merged with it, which takes a separator out
+     * of the parent, and the parent may then have to do the same one level up.
+     */
+    void remove(const Object &x) {
+        if (root == nullptr) {
+            return;
+        }
+        Step path[MaxLevels];
+        Leaf *leaf = findLeaf(x, path);
+        std::size_t i = lowerBound(leaf, x);
+        if (i == leaf->count || comparator(x, leaf->keys[i])) {
+            return; // not found
+        }
+        eraseAt(leaf->keys, leaf->count, i);
+        --leaf->count;
+        --keyCount;
+
+        if (innerLevels == 0) {
+            if (leaf->count == 0) {
+                delete leaf;
+                root = nullptr;
+                head = nullptr;
+                tail = nullptr;
+            }
+            return;
+        }
+        if (leaf->count >= MinLeafKeys || !fixLeaf(leaf, path[innerLevels - 1])) {
+            return;
+        }
+        std::size_t level = innerLevels - 1;
+        while (level > 0 && path[level].node->count < MinInnerKeys) {
+            if (!fixInner(path[level].node, path[level - 1])) {
+                return;
+            }
+            --level;
+        }
+        if (level == 0 && path[0].node->count == 0) {
+            // the root lost its last separator, its only child takes over
+            root = path[0].node->children[0];
+            --innerLevels;
+            delete path[0].node;
+        }
+    }
+
+    /**
+     * @brief call fn on every element from lo to hi, both included, in order
+     * @details one descent to lo, then along the leaves
+     */
+    template<typename Fn>
+    void for_each_in_range(const Object &lo, const Object &hi, Fn fn) const {
+        if (root == nullptr) {
+            return;
+        }
+        const Leaf *leaf = findLeaf(lo);
+        for (std::size_t i = lowerBound(leaf, lo); leaf != nullptr; leaf = leaf->next, i = 0) {
+            for (; i < leaf->count; i++) {
+                if (comparator(hi, leaf->keys[i])) {
+                    return;
+                }
+                fn(leaf->keys[i]);
+            }
+        }
+    }
+
+    void makeEmpty() {
+        std::vector<std::pair<Node *, std::size_t>> pending;
+        if (root != nullptr) {
+            pending.emplace_back(root, 0);
+        }
+        while (!pending.empty()) {
+            Node *t = pending.back().first;
+            std::size_t level = pending.back().second;
+            pending.pop_back();
+            if (level == innerLevels) {
+                delete static_cast<Leaf *>(t);
+            } else {
+                Inner *inner = static_cast<Inner *>(t);
+                for (std::size_t i = 0; i <= inner->count; i++) {
+                    pending.emplace_back(inner->children[i], level + 1);
+                }
+                delete inner;
+            }
+        }
+        root = nullptr;
+        head = nullptr;
+        tail = nullptr;
+        innerLevels = 0;
+        keyCount = 0;
+    }
+
+private:
+
+    struct Node {
+        std::size_t count = 0;   // keys in the node
+    };
+
+    static const std::size_t LeafSlots = (NodeBytes - sizeof(Node) - 2 * sizeof(void *)) / sizeof(Object);
+    static const std::size_t InnerSlots = (NodeBytes - sizeof(Node) - sizeof(void *)) / (sizeof(Object) + sizeof(void *));
+
+    static const std::size_t LeafKeys = LeafSlots - 1;
+    static const std::size_t InnerKeys = InnerSlots - 1;
+    static const std::size_t MinLeafKeys = LeafKeys / 2;
+    static const std::size_t MinInnerKeys = InnerKeys / 2;
+
+    static_assert(LeafKeys >= 2 && InnerKeys >= 2, "NodeBytes is too small for Object");
+
+    // every inner node but the root has at least 2 children, so this covers any n
+    static const std::size_t MaxLevels = 64;
+
+    struct alignas(64) Leaf : Node {
+        Object keys[LeafSlots];
+        Leaf *prev = nullptr;
+        Leaf *next = nullptr;
+    };
+
+    struct alignas(64) Inner : Node {
+        Object keys[InnerSlots];
+        Node *children[InnerSlots + 1];
+    };
+
+    /**
+     * @brief an inner node on the way down and the child the walk took
+     */
+    struct Step {
+        Inner *node;
+        std::size_t index;
+    };
+
+    Node *root = nullptr;
+    Leaf *head = nullptr;          // the leaf with the smallest keys
+    Leaf *tail = nullptr;
+    std::size_t innerLevels = 0;   // levels above the leaves
+    std::size_t keyCount = 0;
+    Comparator comparator;
+
+    std::size_t lowerBound(const Leaf *leaf, const Object &x) const {
+        return std::lower_bound(leaf->keys, leaf->keys + leaf->count, x, comparator) - leaf->keys;
+    }
+
+    // the child whose keys are >= keys[i - 1] and < keys[i]
+    std::size_t childIndex(const Inner *inner, const Object &x) const {
+        return std::upper_bound(inner->keys, inner->keys + inner->count, x, comparator) - inner->keys;
+    }
+
+    Leaf *findLeaf(const Object &x, Step *path = nullptr) const {
+        Node *t = root;
+        for (std::size_t level = 0; level < innerLevels; level++) {
+            Inner *inner = static_cast<Inner *>(t);
+            std::size_t i = childIndex(inner, x);
+            if (path != nullptr) {
+                path[level] = Step{inner, i};
+            }
+            t = inner->children[i];
+        }
+        return static_cast<Leaf *>(t);
+    }
+
+    template<typename T, typename V>
+    static void insertAt(T *array, std::size_t count, std::size_t i, V &&value) {
+        std::move_backward(array + i, array + count, array + count + 1);
+        array[i] = std::forward<V>(value);
+    }
+
+    template<typename T>
+    static void eraseAt(T *array, std::size_t count, std::size_t i) {
+        std::move(array + i + 1, array + count, array + i);
+    }
+
+    /**
+     * @details the new key goes into its leaf, using the spare slot if the leaf was full.
+     * An overfull leaf moves its upper half to a new right sibling, whose first key goes up
+     * to the parent as a separator. That may overfill the parent, which then moves its
+     * upper half to a new sibling and passes its middle key up, and so on. When the root
+     * splits, a new root above it holds the separator.
+     */
+    template<typename X>
+    void insertKey(X &&x) {
+        if (root == nullptr) {
+            Leaf *leaf = new Leaf;
+            root = leaf;
+            head = leaf;
+            tail = leaf;
+        }
+        Step path[MaxLevels];
+        Leaf *leaf = findLeaf(x, path);
+        std::size_t i = lowerBound(leaf, x);
+        if (i < leaf->count && !comparator(x, leaf->keys[i])) {
+            return; // duplicate
+        }
+        insertAt(leaf->keys, leaf->count, i, std::forward<X>(x));
+        ++leaf->count;
+        ++keyCount;
+        if (leaf->count <= LeafKeys) {
+            return;
+        }
+
+        Leaf *right = new Leaf;
+        std::size_t half = leaf->count / 2;
+        std::move(leaf->keys + half, leaf->keys + leaf->count, right->keys);
+        right->count = leaf->count - half;
+        leaf->count = half;
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next != nullptr) {
+            leaf->next->prev = right;
+        } else {
+            tail = right;
+        }
+        leaf->next = right;
+
+        Object separator = right->keys[0];
+        Node *newChild = right;
+        for (std::size_t level = innerLevels; level > 0; level--) {
+            Inner *parent = path[level - 1].node;
+            std::size_t index = path[level - 1].index;
+            insertAt(parent->keys, parent->count, index, std::move(separator));
+            insertAt(parent->children, parent->count + 1, index + 1, newChild);
+            ++parent->count;
+            if (parent->count <= InnerKeys) {
+                return;
+            }
+
+            Inner *sibling = new Inner;
+            std::size_t middle = parent->count / 2;
+            separator = std::move(parent->keys[middle]);
+            std::move(parent->keys + middle + 1, parent->keys + parent->count, sibling->keys);
+            std::copy(parent->children + middle + 1, parent->children + parent->count + 1, sibling->children);
+            sibling->count = parent->count - middle - 1;
+            parent->count = middle;
+            newChild = sibling;
+        }
+
+        Inner *newRoot = new Inner;
+        newRoot->keys[0] = std::move(separator);
+        newRoot->children[0] = root;
+        newRoot->children[1] = newChild;
+        newRoot->count = 1;
+        root = newRoot;
+        ++innerLevels;
+    }
+
+    /**
+     * @brief leaf has too few keys: borrow one from a sibling, or merge with it
+     * @return [true if they merged, so the parent lost a key]
+     */
+    bool fixLeaf(Leaf *leaf, Step step) {
+        Inner *parent = step.node;
+        std::size_t i = step.index;
+        Leaf *left = i > 0 ? static_cast<Leaf *>(parent->children[i - 1]) : nullptr;
+        Leaf *right = i < parent->count ? static_cast<Leaf *>(parent->children[i + 1]) : nullptr;
+
+        if (left != nullptr && left->count > MinLeafKeys) {
+            insertAt(leaf->keys, leaf->count, 0, std::move(left->keys[left->count - 1]));
+            ++leaf->count;
+            --left->count;
+            parent->keys[i - 1] = leaf->keys[0];
+            return false;
+        }
+        if (right != nullptr && right->count > MinLeafKeys) {
+            leaf->keys[leaf->count++] = std::move(right->keys[0]);
+            eraseAt(right->keys, right->count, 0);
+            --right->count;
+            parent->keys[i] = right->keys[0];
+            return false;
+        }
+
+        // the right one of the pair goes, with the separator between them
+        if (left == nullptr) {
+            left = leaf;
+            ++i;
+        } else {
+            right = leaf;
+        }
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next != nullptr) {
+            right->next->prev = left;
+        } else {
+            tail = left;
+        }
+        delete right;
+        eraseAt(parent->keys, parent->count, i - 1);
+        eraseAt(parent->children, parent->count + 1, i);
+        --parent->count;
+        return true;
+    }
+
+    /**
+     * @brief the same for an inner node, whose keys rotate through the parent's separator
+     */
+    bool fixInner(Inner *node, Step step) {
+        Inner *parent = step.node;
+        std::size_t i = step.index;
+        Inner *left = i > 0 ? static_cast<Inner *>(parent->children[i - 1]) : nullptr;
+        Inner *right = i < parent->count ? static_cast<Inner *>(parent->children[i + 1]) : nullptr;
+
+        if (left != nullptr && left->count > MinInnerKeys) {
+            insertAt(node->keys, node->count, 0, std::move(parent->keys[i - 1]));
+            insertAt(node->children, node->count + 1, 0, left->children[left->count]);
+            ++node->count;
+            parent->keys[i - 1] = std::move(left->keys[left->count - 1]);
+            --left->count;
+            return false;
+        }
+        if (right != nullptr && right->count > MinInnerKeys) {
+            node->keys[node->count] = std::move(parent->keys[i]);
+            node->children[node->count + 1] = right->children[0];
+            ++node->count;
+            parent->keys[i] = std::move(right->keys[0]);
+            eraseAt(right->keys, right->count, 0);
+            eraseAt(right->children, right->count + 1, 0);
+            --right->count;
+            return false;
+        }
+
+        if (left == nullptr) {
+            left = node;
+            ++i;
+        } else {
+            right = node;
+        }
+        left->keys[left->count] = std::move(parent->keys[i - 1]);
+        std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+        delete right;
+        eraseAt(parent->keys, parent->count, i - 1);
+        eraseAt(parent->children, parent->count + 1, i);
+        --parent->count;
+        return true;
+    }
+};
+
+#endif //CRACKINGTHECODINGINTERVIEW_BPLUSTREE_H
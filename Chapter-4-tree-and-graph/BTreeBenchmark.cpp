@@ -0,0 +1,28 @@
+/**
+ * Benchmarks for BPlusTree against BinarySearchTree and std::set, with random keys:
+ *  - insert, contains and remove
+ *  - range scans of 100 consecutive keys
+ *
+ * usage: BTreeBenchmark [maxKeys], 10^7 keys by default
+ */
+
+#include "BinarySearchTree.h"
+#include "BPlusTree.h"
+#include "TreeBenchmark.h"
+
+int main(int argc, char **argv) {
+    std::size_t maxKeys = benchmarkMaxKeys(argc, argv, 10000000);
+    for (std::size_t n : benchmarkSizes(maxKeys)) {
+        benchmarkTree<BPlusTree<int>>("BPlusTree 256B", n, KeyOrder::Random);
+        benchmarkTree<BPlusTree<int, std::less<int>, 512>>("BPlusTree 512B", n, KeyOrder::Random);
+        benchmarkTree<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n, KeyOrder::Random);
+        benchmarkTree<BinarySearchTree<int, std::less<int>, AvlBalance, SlabAllocation<>>>("AVL slab", n,
+                                                                                              KeyOrder::Random);
+        benchmarkTree<StdSet<int>>("std::set", n, KeyOrder::Random);
+
+        benchmarkScan<BPlusTree<int>>("BPlusTree 256B", n);
+        benchmarkScan<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n);
+        benchmarkScan<StdSet<int>>("std::set", n);
+    }
+    return 0;
+}
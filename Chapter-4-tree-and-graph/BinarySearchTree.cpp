@@ -3,272 +3,16 @@
 //
 
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <random>
 #include <chrono>
-/**
- * note we (like the STL) use L value reference
- * and R value reference version of a method
- */
-
-
-/**
- * @brief a BinarySearchTree in C++
- *
- * @details We use the technique of having private member functions pass a pointer
- * variable using call-by-reference. Then, public member functions can pass a pointer to
- * the root to the private recursive member functions. In other words, the private member
- * functions are called by the public member and are recursive.
- *
- *
- */
-template<typename Object, typename Comparator=std::less<Object>>
-class BinarySearchTree {
-public:
-
-    BinarySearchTree()
-            : root(nullptr) {};
-
-    BinarySearchTree(const BinarySearchTree &rhs)
-            : root(nullptr) {
-        root = clone(rhs.root);
-    }
-
-    BinarySearchTree &operator=(const BinarySearchTree &rhs) {
-        BinarySearchTree copy = rhs;
-        std::swap(*this, rhs);
-        return *this;
-    }
-
-//    BinarySearchTree(BinarySearchTree &&rhs) noexcept
-//            : root(nullptr) {
-//        clone();
-//    }
-//
-//    BinarySearchTree &operator=(BinarySearchTree &&rhs) noexcept;
-
-    ~BinarySearchTree() {
-        makeEmpty();
-    };
-
-    const Object &findMin() const {
-        return findMin(root)->element;
-    }
-
-    const Object &findMax() const {
-        return findMax(root)->element;
-    }
-
-    bool contains(const Object &x) {
-        return contains(x, root);
-    }
-
-    bool empty() {
-        return root == nullptr;
-    }
-
-    void printTree() {
-        printTree("", root, false);
-    }
-
-    void makeEmpty() {
-        makeEmpty(root);
-    }
-
-    void insert(const Object &x) {
-        insert(x, root);
-    }
-
-    void insert(Object &&x) {
-        insert(std::move(x), root);
-    }
-
-    void remove(const Object &x) {
-        remove(x, root);
-    }
-
-private:
-
-    struct BinaryNode {
-        Object element;
-        BinaryNode *left;
-        BinaryNode *right;
-        int freq = 0; // counter for frequency of occurrences of element in tree
-
-        BinaryNode(const Object &theElement, BinaryNode *lt, BinaryNode *rt)
-                : element{theElement}, left{lt}, right{rt} {}
-
-        BinaryNode(Object &&theElement, BinaryNode *lt, BinaryNode *rt)
-                : element{std::move(theElement)}, left{lt}, right{rt} {}
-    };
-
-    BinaryNode *root = nullptr;
-    Comparator comparator;
-
-    void insert(const Object &x, BinaryNode *&t) {
-        if (t == nullptr) {
-            t = new BinaryNode(x, nullptr, nullptr);
-        } else if (comparator(x, t->element)) {
-            insert(x, t->left);
-        } else if (t->element < x) {
-            insert(comparator(x, t->right));
-        } else {
-            // found object x. is a duplicate. Ignore
-        }
-    }
-
-    void insert(Object &&x, BinaryNode *&t) {
-        if (t == nullptr) {
-            t = new BinaryNode(std::move(x), nullptr, nullptr);
-        } else if (comparator(x, t->element)) {
-            insert(std::move(x), t->left);
-        } else if (comparator(t->element, x)) {
-            insert(std::move(x), t->right);
-        } else {
-            // duplicate.
-            t->freq++;
-        }
-    }
-
-    void remove(const Object &x, BinaryNode *&t) {
-        if (t == nullptr) {
-            return; // not found
-        } else if (comparator(x, t->element)) { // i.e. c < t->element
-            remove(x, t->left);
-        } else if (comparator(t->element, x)) { // i.e. t-element < x
-            remove(x, t->right);
-        } else if (t->left != nullptr && t->right != nullptr) {
-            /**
-             * When both left and right are both non-null, we replace node t's data
-             * with that of the lowest node from the right tree. This works because the
-             * structure of the binary search tree ensures that the minimum node in the
-             * right tree, from any other node is the next largest number that is smaller than
-             * right value
-             */
-            t->element = findMin(t->right)->element;
-            remove(t->element, t->right);
-        } else {
-            // When we have a leaf node, we take a reference to the leaf node
-            // and call it oldNode. then we check whether the left is a nullptr
-            // if it is then we store the value of right in t, which is a nullptr
-            // when we're dealing with a leaf node.
-            //
-            // This code is elegant, since we also deal with the case of 1 child
-            // at the same time
-            //
-            BinaryNode *oldNode = t;
-            t = (t->left != nullptr) ? t->left : t->right;
-            delete oldNode;
-        }
-    }
-
-    /**
-     * @brief returns true if there is a node in @param t
-     * that has item @param x.
-     */
-    bool contains(const Object &x, BinaryNode *t) {
-        // leaf nodes have a nullptr for both left and right
-        // if we hit one, x is not in subtree t.
-        if (t == nullptr) {
-            return false;
-        } else if (comparator(x, t->element)) {
-            /**
-             * When x is less than the value of the current T
-             * call contains again with the node to the left.
-             * Recall that in a binary search tree,
-             * nodes are arranged such that left is less than
-             * t which is less than right.
-             */
-            return contains(x, t->left);
-        } else if (comparator(t->element, x)) {
-            /**
-             * When x is greater than the value of current t,
-             * we call contains again to check the value right
-             * against x.
-             *
-             * Obviously, x must implement the comparison operators.
-             */
-            return contains(x, t->right);
-        } else {
-            // if x is not less than or greater than the value of t,
-            // then it is equal.
-            return true;
-        }
-    }
-
-    /**
-     * @brief find the smallest value in the tree
-     * @details keep traversing left
-     */
-    BinaryNode *findMin(BinaryNode *t) const {
-        if (t == nullptr) {
-            return nullptr;
-        }
-        if (t->left == nullptr) {
-            return t;
-        }
-        return findMin(t->left);
-    }
-
-    BinaryNode *findMax(BinaryNode *t) const {
-        // try a non-recursive implementation
-        if (t != nullptr) {
-            while (t->right != nullptr) {
-                t = t->right;
-            }
-        }
-        return t;
-    }
-
-    void makeEmpty(BinaryNode *t) {
-        if (t != nullptr) {
-            makeEmpty(t->left);
-            makeEmpty(t->right);
-            delete t;
-        }
-        t = nullptr;
-    }
-
-    void printTree(const std::string &prefix, const BinaryNode *node, bool isLeft) {
-        if (node != nullptr) {
-            std::cout << prefix;
-
-            std::cout << (isLeft ? "├──" : "└──");
-
-            // print the value of the node
-            std::cout << node->element << std::endl;
-
-            // enter the next tree level - left and right branch
-            printTree(prefix + (isLeft ? "│   " : "    "), node->left, true);
-            printTree(prefix + (isLeft ? "│   " : "    "), node->right, false);
-        }
-    }
-
-    BinaryNode *clone(BinaryNode *t) const {
-        // when t is nullptr, we return nullptr to end the recursion
-        if (t == nullptr) {
-            return nullptr;
-        }
-        /**
-         * e.g.
-         *     50
-         *  38    55
-         * this is an elegant algorithm. We start at the root node 50. Since
-         * the root node is not nullptr, we create a new BinaryNode using 50 as its
-         * value. As the new root node left and right nodes, we pass in the return
-         * value of another call to clone but with left or right respectively.
-         * For instance, after the root node, the lt node call to clone is entered.
-         * The lt is not null, so we proceed to create it. The value of left is 38
-         * which is used as t->element. This time, calls to clone(left) and clone(right)
-         * both return nullptr meaning they are popped off the stack and we return the the
-         * frame containing the root node. We repeat the process with the right node.
-         *
-         * Very nice!
-         */
-        return new BinaryNode(t->element, clone(t->left), clone(t->right));
-    }
-
-};
-
+#include <cmath>
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "BinarySearchTree.h"
 
 class BinarySearchTreeTests : public ::testing::Test {
 public:
@@ -413,6 +157,457 @@ TEST_F(BinarySearchTreeTests, Clone) {
 }
 
 
+/**
+ * @brief random inserts (rvalue and const lvalue overloads) and removes against std::set
+ */
+template<typename Tree>
+void checkAgainstSet(int range) {
+    std::mt19937 generator(11);
+    Tree bst;
+    std::set<int> expected;
+    for (int i = 0; i < 20000; i++) {
+        int x = static_cast<int>(generator() % range);
+        switch (generator() % 3) {
+            case 0:
+                bst.remove(x);
+                expected.erase(x);
+                break;
+            case 1:
+                bst.insert(int{x});
+                expected.insert(x);
+                break;
+            default:
+                const int copy = x;
+                bst.insert(copy);
+                expected.insert(x);
+        }
+        ASSERT_EQ(expected.count(x) == 1, bst.contains(x));
+        ASSERT_EQ(expected.empty(), bst.empty());
+        if (!expected.empty()) {
+            ASSERT_EQ(*expected.begin(), bst.findMin());
+            ASSERT_EQ(*expected.rbegin(), bst.findMax());
+        }
+    }
+    for (int x = 0; x < range; x++) {
+        ASSERT_EQ(expected.count(x) == 1, bst.contains(x));
+    }
+}
+
+TEST_F(BinarySearchTreeTests, BalancedTreesMatchSet) {
+    checkAgainstSet<BinarySearchTree<int>>(1000);
+    checkAgainstSet<BinarySearchTree<int, std::less<int>, AvlBalance>>(1000);
+    checkAgainstSet<BinarySearchTree<int, std::less<int>, RedBlackBalance>>(1000);
+    checkAgainstSet<BinarySearchTree<int, std::less<int>, RedBlackBalance>>(20);
+}
+
+TEST_F(BinarySearchTreeTests, SlabAllocatedTreesMatchSet) {
+    checkAgainstSet<BinarySearchTree<int, std::less<int>, Unbalanced, SlabAllocation<>>>(1000);
+    checkAgainstSet<BinarySearchTree<int, std::less<int>, AvlBalance, SlabAllocation<256>>>(1000);
+    checkAgainstSet<BinarySearchTree<int, std::less<int>, RedBlackBalance, SlabAllocation<256>>>(20);
+}
+
+/**
+ * @brief compact keeps the elements and the shape, and frees what remove left behind
+ */
+template<NodeLayout layout>
+void checkCompact() {
+    BinarySearchTree<std::string, std::less<std::string>, AvlBalance, SlabAllocation<1024>> bst;
+    for (int i = 0; i < 1000; i++) {
+        bst.insert(std::to_string(i));
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        bst.remove(std::to_string(i));
+    }
+    int height = bst.height();
+    bst.compact(layout);
+    ASSERT_EQ(height, bst.height());
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(i % 3 != 0, bst.contains(std::to_string(i)));
+    }
+    bst.insert("x");
+    ASSERT_EQ("x", bst.findMax());
+    bst.makeEmpty();
+    ASSERT_TRUE(bst.empty());
+}
+
+TEST_F(BinarySearchTreeTests, CompactTree) {
+    checkCompact<NodeLayout::BreadthFirst>();
+    checkCompact<NodeLayout::VanEmdeBoas>();
+
+    BinarySearchTree<int, std::less<int>, Unbalanced, SlabAllocation<>> path;
+    for (int i = 0; i < 1000; i++) {
+        path.insert(i);
+    }
+    path.compact(NodeLayout::VanEmdeBoas);
+    ASSERT_EQ(999, path.height());
+    ASSERT_EQ(999, path.findMax());
+    ASSERT_TRUE(path.contains(500));
+}
+
+TEST_F(BinarySearchTreeTests, FreezeTree) {
+    const int range = 2000;
+    std::mt19937 generator(5);
+    for (int n : {0, 1, 2, 3, 7, 8, 100, 1000}) {
+        BinarySearchTree<int, std::less<int>, AvlBalance> bst;
+        std::set<int> expected;
+        while (static_cast<int>(expected.size()) < n) {
+            int x = static_cast<int>(generator() % range);
+            bst.insert(x);
+            expected.insert(x);
+        }
+        FrozenSearchTree<int> frozen = bst.freeze();
+        ASSERT_EQ(expected.size(), frozen.size());
+        for (int x = -1; x <= range; x++) {
+            auto lowerBound = expected.lower_bound(x);
+            ASSERT_EQ(expected.count(x) == 1, frozen.contains(x));
+            ASSERT_EQ(static_cast<std::size_t>(std::distance(expected.begin(), lowerBound)), frozen.rank(x));
+            if (lowerBound == expected.end()) {
+                ASSERT_EQ(nullptr, frozen.lower_bound(x));
+            } else {
+                ASSERT_EQ(*lowerBound, *frozen.lower_bound(x));
+            }
+        }
+    }
+}
+
+/**
+ * @brief rank, select, count and count_range against a std::multiset, with duplicates
+ */
+template<typename Tree>
+void checkOrderStatistics(int range) {
+    std::mt19937 generator(7);
+    Tree bst;
+    std::multiset<int> expected;
+    for (int i = 0; i < 5000; i++) {
+        int x = static_cast<int>(generator() % range);
+        if (generator() % 3 == 0) {
+            // an iterator to x's successor outlives removing x, even from two children
+            auto next = bst.upper_bound(x);
+            bst.remove(x);
+            expected.erase(x);
+            if (next != bst.end()) {
+                ASSERT_TRUE(next == bst.lower_bound(*next));
+            }
+        } else {
+            bst.insert(x);
+            expected.insert(x);
+        }
+        ASSERT_EQ(expected.size(), bst.size());
+        int y = static_cast<int>(generator() % (range + 2)) - 1;
+        ASSERT_EQ(expected.count(y), bst.count(y));
+        ASSERT_EQ(static_cast<std::size_t>(std::distance(expected.begin(), expected.lower_bound(y))), bst.rank(y));
+        int lo = std::min(x, y);
+        int hi = std::max(x, y);
+        ASSERT_EQ(static_cast<std::size_t>(std::distance(expected.lower_bound(lo), expected.upper_bound(hi))),
+                  bst.count_range(lo, hi));
+        ASSERT_EQ(0u, bst.count_range(hi + 1, lo));
+        if (!expected.empty()) {
+            std::size_t k = generator() % expected.size();
+            ASSERT_EQ(*std::next(expected.begin(), static_cast<long>(k)), bst.select(k));
+        }
+    }
+    ASSERT_THROW(bst.select(expected.size()), typename Tree::RankOutOfRangeException);
+}
+
+TEST_F(BinarySearchTreeTests, OrderStatistics) {
+    checkOrderStatistics<BinarySearchTree<int>>(300);
+    checkOrderStatistics<BinarySearchTree<int, std::less<int>, AvlBalance>>(300);
+    checkOrderStatistics<BinarySearchTree<int, std::less<int>, RedBlackBalance>>(300);
+    checkOrderStatistics<BinarySearchTree<int, std::less<int>, RedBlackBalance, SlabAllocation<>>>(30);
+}
+
+/**
+ * @brief walks forwards, backwards and over ranges against std::set
+ */
+template<typename Tree>
+void checkIterators(const Tree &bst, const std::set<int> &expected, int range) {
+    ASSERT_EQ(std::vector<int>(expected.begin(), expected.end()), std::vector<int>(bst.begin(), bst.end()));
+    std::vector<int> backwards;
+    for (auto it = bst.end(); it != bst.begin();) {
+        backwards.push_back(*--it);
+    }
+    ASSERT_EQ(std::vector<int>(expected.rbegin(), expected.rend()), backwards);
+
+    for (int x = -1; x <= range; x++) {
+        auto lower = bst.lower_bound(x);
+        auto upper = bst.upper_bound(x);
+        ASSERT_EQ(expected.lower_bound(x) == expected.end(), lower == bst.end());
+        ASSERT_EQ(expected.upper_bound(x) == expected.end(), upper == bst.end());
+        if (lower != bst.end()) {
+            ASSERT_EQ(*expected.lower_bound(x), *lower);
+        }
+        if (upper != bst.end()) {
+            ASSERT_EQ(*expected.upper_bound(x), *upper);
+        }
+        auto equal = bst.equal_range(x);
+        ASSERT_EQ(expected.count(x), static_cast<std::size_t>(std::distance(equal.first, equal.second)));
+
+        std::vector<int> scanned;
+        bst.for_each_in_range(x, x + 10, [&scanned](int y) {
+            scanned.push_back(y);
+        });
+        ASSERT_EQ(std::vector<int>(expected.lower_bound(x), expected.upper_bound(x + 10)), scanned);
+    }
+}
+
+template<typename Tree>
+void checkIteratorsAfterUpdates(int range) {
+    std::mt19937 generator(13);
+    Tree bst;
+    std::set<int> expected;
+    for (int i = 0; i < 3000; i++) {
+        int x = static_cast<int>(generator() % range);
+        if (generator() % 3 == 0) {
+            // an iterator to x's successor outlives removing x, even from two children
+            auto next = bst.upper_bound(x);
+            bst.remove(x);
+            expected.erase(x);
+            if (next != bst.end()) {
+                ASSERT_TRUE(next == bst.lower_bound(*next));
+            }
+        } else {
+            bst.insert(x);
+            expected.insert(x);
+        }
+        if (i % 500 == 0) {
+            checkIterators(bst, expected, range);
+        }
+    }
+    checkIterators(bst, expected, range);
+    Tree copy = bst;
+    checkIterators(copy, expected, range);
+    copy.compact(NodeLayout::VanEmdeBoas);
+    checkIterators(copy, expected, range);
+}
+
+TEST_F(BinarySearchTreeTests, Iterators) {
+    checkIteratorsAfterUpdates<BinarySearchTree<int>>(500);
+    checkIteratorsAfterUpdates<BinarySearchTree<int, std::less<int>, AvlBalance>>(500);
+    checkIteratorsAfterUpdates<BinarySearchTree<int, std::less<int>, RedBlackBalance, SlabAllocation<>>>(500);
+
+    BinarySearchTree<int> empty;
+    ASSERT_TRUE(empty.begin() == empty.end());
+    ASSERT_TRUE(empty.lower_bound(1) == empty.end());
+}
+
+/**
+ * @brief fromSorted and merge build minimal height trees that stay usable for every policy
+ */
+template<typename Tree>
+void checkBulkLoad() {
+    std::mt19937 generator(17);
+    for (int n : {0, 1, 2, 3, 7, 8, 1000}) {
+        std::vector<int> keys;
+        for (int i = 0; i < n; i++) {
+            keys.push_back(static_cast<int>(generator() % (2 * n)));
+        }
+        std::sort(keys.begin(), keys.end());
+        std::multiset<int> expected(keys.begin(), keys.end());
+        Tree bst = Tree::fromSorted(keys);
+        std::set<int> distinct(keys.begin(), keys.end());
+        ASSERT_EQ(distinct.empty() ? -1 : static_cast<int>(std::log2(distinct.size())), bst.height());
+        ASSERT_EQ(expected.size(), bst.size());
+        ASSERT_EQ(std::vector<int>(distinct.begin(), distinct.end()), std::vector<int>(bst.begin(), bst.end()));
+
+        std::vector<int> more;
+        for (int i = 0; i < n; i++) {
+            more.push_back(static_cast<int>(generator() % (3 * n)));
+        }
+        Tree other;
+        for (int x : more) {
+            other.insert(x);
+            expected.insert(x);
+            distinct.insert(x);
+        }
+        bst.merge(other);
+        ASSERT_TRUE(other.empty());
+        ASSERT_EQ(distinct.empty() ? -1 : static_cast<int>(std::log2(distinct.size())), bst.height());
+        ASSERT_EQ(expected.size(), bst.size());
+        for (int x = 0; x < 3 * n; x++) {
+            ASSERT_EQ(expected.count(x), bst.count(x));
+        }
+
+        // the balancing still works on the rebuilt tree
+        for (int x = 0; x < 3 * n; x += 2) {
+            bst.remove(x);
+            distinct.erase(x);
+        }
+        for (int x = 3 * n; x < 6 * n; x++) {
+            bst.insert(x);
+            distinct.insert(x);
+        }
+        ASSERT_EQ(std::vector<int>(distinct.begin(), distinct.end()), std::vector<int>(bst.begin(), bst.end()));
+    }
+    ASSERT_THROW(Tree::fromSorted(std::vector<int>{1, 3, 2}), typename Tree::NotSortedException);
+}
+
+TEST_F(BinarySearchTreeTests, FromSortedAndMerge) {
+    checkBulkLoad<BinarySearchTree<int>>();
+    checkBulkLoad<BinarySearchTree<int, std::less<int>, AvlBalance>>();
+    checkBulkLoad<BinarySearchTree<int, std::less<int>, RedBlackBalance, SlabAllocation<>>>();
+
+    typedef BinarySearchTree<int, std::less<int>, AvlBalance> AvlTree;
+    AvlTree avl = AvlTree::fromSorted(std::set<int>{1, 2, 3, 4, 5, 6, 7, 8, 9});
+    ASSERT_EQ(5, avl.select(4));
+    for (int i = 10; i < 100000; i++) {
+        avl.insert(i);
+    }
+    ASSERT_LE(avl.height(), 1.44 * std::log2(100000 + 2));
+}
+
+/**
+ * @brief an int whose copies and moves throw once copiesLeft runs out, and that counts the
+ * live instances, so a leaked node shows up
+ */
+struct ThrowingCopy {
+    static int copiesLeft;
+    static int live;
+    int value;
+
+    ThrowingCopy(int value) : value(value) {
+        live++;
+    }
+
+    ThrowingCopy(const ThrowingCopy &other) : value(other.value) {
+        if (copiesLeft-- == 0) {
+            throw std::runtime_error("copy");
+        }
+        live++;
+    }
+
+    ThrowingCopy(ThrowingCopy &&other) : ThrowingCopy(static_cast<const ThrowingCopy &>(other)) {}
+
+    ThrowingCopy &operator=(const ThrowingCopy &) = default;
+
+    ~ThrowingCopy() {
+        live--;
+    }
+
+    bool operator<(const ThrowingCopy &rhs) const {
+        return value < rhs.value;
+    }
+};
+
+int ThrowingCopy::copiesLeft = -1;
+int ThrowingCopy::live = 0;
+
+/**
+ * @brief std::less on strings that throws once comparisonsLeft runs out
+ */
+struct ThrowingLess {
+    static int comparisonsLeft;
+
+    bool operator()(const std::string &lhs, const std::string &rhs) const {
+        if (comparisonsLeft-- == 0) {
+            throw std::runtime_error("compare");
+        }
+        return lhs < rhs;
+    }
+};
+
+int ThrowingLess::comparisonsLeft = -1;
+
+TEST_F(BinarySearchTreeTests, FromSortedAndMergeUndoOnThrow) {
+    typedef BinarySearchTree<ThrowingCopy, std::less<ThrowingCopy>, AvlBalance> CopyTree;
+    std::vector<ThrowingCopy> sorted{1, 2, 2, 3, 4, 5};
+    ThrowingCopy::copiesLeft = 3;
+    ASSERT_THROW(CopyTree::fromSorted(sorted), std::runtime_error);
+    ASSERT_EQ(6, ThrowingCopy::live);
+
+    // the copying path: moves can throw, so other's elements are copied
+    ThrowingCopy::copiesLeft = -1;
+    CopyTree tree = CopyTree::fromSorted(std::vector<ThrowingCopy>{2, 4, 6});
+    CopyTree other = CopyTree::fromSorted(std::vector<ThrowingCopy>{1, 2, 3, 5, 7});
+    int before = ThrowingCopy::live;
+    ThrowingCopy::copiesLeft = 2;
+    ASSERT_THROW(tree.merge(other), std::runtime_error);
+    ThrowingCopy::copiesLeft = -1;
+    ASSERT_EQ(before, ThrowingCopy::live);
+    ASSERT_EQ(3u, tree.size());
+    ASSERT_EQ(5u, other.size());
+    ASSERT_EQ(1u, tree.count(2));
+    ASSERT_EQ(1u, other.count(2));
+    tree.merge(other);
+    ASSERT_EQ(8u, tree.size());
+    ASSERT_EQ(2u, tree.count(2));
+
+    // the moving path: strings move without throwing, and go back to other
+    typedef BinarySearchTree<std::string, ThrowingLess, RedBlackBalance, SlabAllocation<>> StringTree;
+    std::vector<std::string> mine{"b", "d", "f"};
+    std::vector<std::string> theirs{"a", "c", "d", "e", "g"};
+    StringTree strings = StringTree::fromSorted(mine);
+    StringTree otherStrings = StringTree::fromSorted(theirs);
+    ThrowingLess::comparisonsLeft = 5;
+    ASSERT_THROW(strings.merge(otherStrings), std::runtime_error);
+    ThrowingLess::comparisonsLeft = -1;
+    ASSERT_EQ(mine, std::vector<std::string>(strings.begin(), strings.end()));
+    ASSERT_EQ(theirs, std::vector<std::string>(otherStrings.begin(), otherStrings.end()));
+    ASSERT_EQ(1u, strings.count("d"));
+    strings.merge(otherStrings);
+    ASSERT_EQ(8u, strings.size());
+    ASSERT_TRUE(otherStrings.empty());
+}
+
+TEST_F(BinarySearchTreeTests, BalancedTreesStayLogarithmicOnSortedInput) {
+    const int N = 100000;
+    BinarySearchTree<int, std::less<int>, AvlBalance> avl;
+    BinarySearchTree<int, std::less<int>, RedBlackBalance> redBlack;
+    for (int i = 0; i < N; i++) {
+        avl.insert(i);
+        redBlack.insert(N - i);
+    }
+    ASSERT_LE(avl.height(), 1.44 * std::log2(N + 2));
+    ASSERT_LE(redBlack.height(), 2 * std::log2(N + 1));
+
+    for (int i = 0; i < N; i += 3) {
+        avl.remove(i);
+        redBlack.remove(N - i);
+    }
+    ASSERT_LE(avl.height(), 1.44 * std::log2(N + 2));
+    ASSERT_LE(redBlack.height(), 2 * std::log2(N + 1));
+    ASSERT_EQ(1, avl.findMin());
+    ASSERT_EQ(N - 2, avl.findMax());
+}
+
+TEST_F(BinarySearchTreeTests, AssignBalancedTree) {
+    BinarySearchTree<int, std::less<int>, AvlBalance> bst;
+    for (int i = 0; i < 100; i++) {
+        bst.insert(i);
+    }
+    BinarySearchTree<int, std::less<int>, AvlBalance> copy;
+    copy.insert(1000);
+    copy = bst;
+    ASSERT_FALSE(copy.contains(1000));
+    ASSERT_TRUE(copy.contains(99));
+    ASSERT_EQ(bst.height(), copy.height());
+}
+
+
+TEST_F(BinarySearchTreeTests, DeepUnbalancedTree) {
+    const int N = 20000;
+    BinarySearchTree<int> bst;
+    for (int i = 0; i < N; i++) {
+        bst.insert(i);
+    }
+    ASSERT_EQ(N - 1, bst.height());
+
+    BinarySearchTree<int> copy = bst;
+    ASSERT_EQ(N - 1, copy.height());
+    ASSERT_TRUE(copy.contains(N - 1));
+    ASSERT_TRUE(copy.containsRecursive(N - 1));
+    for (int i = 0; i < N; i += 2) {
+        copy.remove(i);
+    }
+    ASSERT_EQ(1, copy.findMin());
+    ASSERT_FALSE(copy.contains(N - 2));
+    ASSERT_TRUE(bst.contains(N - 2));
+
+    bst.makeEmpty();
+    ASSERT_TRUE(bst.empty());
+    ASSERT_EQ(-1, bst.height());
+}
+
+
 #include <cmath>
 #include <string>
 
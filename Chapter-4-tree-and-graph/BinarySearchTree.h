@@ -0,0 +1,1017 @@
+//
+// Created by Ciaran on 31/08/2021.
+//
+
+#ifndef CRACKINGTHECODINGINTERVIEW_BINARYSEARCHTREE_H
+#define CRACKINGTHECODINGINTERVIEW_BINARYSEARCHTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "FrozenSearchTree.h"
+#include "TreeAllocation.h"
+#include "TreeBalancing.h"
+
+/**
+ * note we (like the STL) use L value reference
+ * and R value reference version of a method
+ */
+
+
+/**
+ * @brief a BinarySearchTree in C++
+ *
+ * @details The operations walk the tree in a loop, holding a pointer to the link
+ * (root, or a left or right field) they are looking at, so the link can be changed in
+ * place without knowing the parent. Nothing recurses along a path of the tree: a plain
+ * tree built from sorted keys is a path n nodes deep, and a recursive walk would overflow
+ * the call stack. fromSorted and merge do recurse, on a tree they build perfectly balanced.
+ * The recursive contains is kept as containsRecursive for comparison.
+ *
+ * The Balance policy (see TreeBalancing.h) decides whether and how the tree rebalances
+ * itself on the way back up from insert and remove. The default, Unbalanced, keeps the
+ * plain BST, whose height follows the insertion order: sorted keys make it a linked list.
+ * AvlBalance and RedBlackBalance keep the height O(log n) whatever the order.
+ *
+ * The Allocation policy (see TreeAllocation.h) decides where the nodes live: one new per
+ * node by default, or the tree's own slabs with SlabAllocation. compact() rewrites the
+ * nodes in breadth first or van Emde Boas order for trees that are mostly looked up.
+ *
+ * Every node knows how many elements its subtree holds, duplicates included, which gives
+ * rank, select, count and count_range in O(height). Insert and remove adjust the sizes
+ * along their path, and rotations recompute them through BinaryNode::refresh.
+ *
+ * Nodes also point at their parent, so an iterator is just a node: the next node is the
+ * leftmost one in its right subtree or, without one, the first ancestor it is to the left
+ * of. Iterators visit every distinct element once; count gives the number of copies.
+ */
+template<typename Object, typename Comparator=std::less<Object>, typename Balance=Unbalanced,
+        typename Allocation=HeapAllocation>
+class BinarySearchTree {
+    struct BinaryNode;
+
+public:
+
+    BinarySearchTree()
+            : root(nullptr) {};
+
+    BinarySearchTree(const BinarySearchTree &rhs)
+            : root(nullptr) {
+        root = clone(rhs.root);
+    }
+
+    BinarySearchTree &operator=(const BinarySearchTree &rhs) {
+        BinarySearchTree copy = rhs;
+        std::swap(root, copy.root);
+        nodes.swap(copy.nodes);
+        return *this;
+    }
+
+    BinarySearchTree(BinarySearchTree &&rhs) noexcept
+            : root(rhs.root) {
+        rhs.root = nullptr;
+        nodes.swap(rhs.nodes);
+    }
+
+    BinarySearchTree &operator=(BinarySearchTree &&rhs) noexcept {
+        std::swap(root, rhs.root);
+        nodes.swap(rhs.nodes);
+        return *this;
+    }
+
+    /**
+     * @brief a perfectly balanced tree of the elements of sorted, in O(n)
+     * @details equal elements become one node with their count in freq. All the nodes
+     * are created first, in order, which with SlabAllocation puts them side by side, and
+     * then linked up by createBst, the construction of 4.2_minimal_tree.cpp: the middle
+     * element is the root and the halves on either side its subtrees. Throws
+     * NotSortedException if an element is less than the one before it. If anything
+     * throws, the nodes created so far are destroyed.
+     */
+    template<typename Range>
+    static BinarySearchTree fromSorted(const Range &sorted) {
+        BinarySearchTree tree;
+        std::vector<BinaryNode *> inOrder;
+        try {
+            for (const auto &x : sorted) {
+                if (!inOrder.empty()) {
+                    BinaryNode *last = inOrder.back();
+                    if (tree.comparator(x, last->element)) {
+                        throw NotSortedException();
+                    }
+                    if (!tree.comparator(last->element, x)) {
+                        last->freq++;
+                        continue;
+                    }
+                }
+                // the slot first, so push_back cannot throw away a node already created
+                inOrder.push_back(nullptr);
+                inOrder.back() = tree.nodes.create(x, nullptr, nullptr);
+            }
+        } catch (...) {
+            for (BinaryNode *t : inOrder) {
+                if (t != nullptr) {
+                    tree.nodes.destroy(t);
+                }
+            }
+            throw;
+        }
+        tree.root = tree.build(inOrder);
+        return tree;
+    }
+
+    /**
+     * @brief move every element of other into this tree, in O(n + m)
+     * @details both trees are flattened in order and merged like the two halves of a
+     * merge sort, and the result is rebuilt balanced as in fromSorted. This tree's nodes
+     * are relinked; other's elements are moved into new nodes here, since other's nodes
+     * may belong to its own slabs. Equal elements add up their counts. other ends empty.
+     *
+     * Neither tree changes until all the new nodes exist, and a throw while creating them
+     * (or comparing) leaves both as they were: the new nodes are destroyed and the
+     * elements they took go back to other. Elements are only moved when moving them back
+     * cannot throw, and copied otherwise.
+     */
+    void merge(BinarySearchTree &other) {
+        if (&other == this) {
+            return;
+        }
+        std::vector<BinaryNode *> mine;
+        std::vector<BinaryNode *> theirs;
+        forEachInOrder(root, [&mine](BinaryNode *t) {
+            mine.push_back(t);
+        });
+        forEachInOrder(other.root, [&theirs](BinaryNode *t) {
+            theirs.push_back(t);
+        });
+
+        // reserved up front, so that only creating nodes and comparing can throw below
+        std::vector<BinaryNode *> merged;
+        merged.reserve(mine.size() + theirs.size());
+        std::vector<std::pair<BinaryNode *, BinaryNode *>> created;   // new node, other's node
+        created.reserve(theirs.size());
+        std::vector<std::pair<BinaryNode *, BinaryNode *>> equal;     // this tree's node, other's
+        equal.reserve(std::min(mine.size(), theirs.size()));
+        std::size_t i = 0;
+        std::size_t j = 0;
+        try {
+            while (i < mine.size() || j < theirs.size()) {
+                if (j == theirs.size() || (i < mine.size() && comparator(mine[i]->element, theirs[j]->element))) {
+                    merged.push_back(mine[i++]);
+                } else if (i == mine.size() || comparator(theirs[j]->element, mine[i]->element)) {
+                    BinaryNode *t = nodes.create(takeElement(theirs[j]->element), nullptr, nullptr);
+                    t->freq = theirs[j]->freq;
+                    created.emplace_back(t, theirs[j++]);
+                    merged.push_back(t);
+                } else {
+                    equal.emplace_back(mine[i++], theirs[j++]);
+                    merged.push_back(equal.back().first);
+                }
+            }
+        } catch (...) {
+            for (const auto &step : created) {
+                if (MergeMoves) {
+                    step.second->element = std::move(step.first->element);
+                }
+                nodes.destroy(step.first);
+            }
+            throw;
+        }
+        for (const auto &step : equal) {
+            step.first->freq += step.second->freq + 1;
+        }
+        other.makeEmpty();
+        root = build(merged);
+    }
+
+    ~BinarySearchTree() {
+        makeEmpty();
+    };
+
+    const Object &findMin() const {
+        return findMin(root)->element;
+    }
+
+    const Object &findMax() const {
+        return findMax(root)->element;
+    }
+
+    /**
+     * @brief returns true if there is a node that has item @param x.
+     */
+    bool contains(const Object &x) const {
+        return find(x) != nullptr;
+    }
+
+    bool containsRecursive(const Object &x) const {
+        return contains(x, root);
+    }
+
+    bool empty() {
+        return root == nullptr;
+    }
+
+    /**
+     * @brief the number of elements, counting every insert of a duplicate
+     */
+    std::size_t size() const {
+        return sizeOf(root);
+    }
+
+    /**
+     * @brief how many times x is in the tree, 0 if it is not
+     */
+    std::size_t count(const Object &x) const {
+        const BinaryNode *t = find(x);
+        return t == nullptr ? 0 : multiplicity(t);
+    }
+
+    /**
+     * @brief the number of elements less than x
+     * @details every time the walk goes right, the node and its left subtree are less
+     */
+    std::size_t rank(const Object &x) const {
+        std::size_t less = 0;
+        for (const BinaryNode *t = root; t != nullptr;) {
+            if (comparator(t->element, x)) {
+                less += sizeOf(t->left) + multiplicity(t);
+                t = t->right;
+            } else {
+                t = t->left;
+            }
+        }
+        return less;
+    }
+
+    /**
+     * @brief the element at position k, from 0, in sorted order with duplicates repeated
+     * @details e.g. select(0) is findMin() and select(size() - 1) is findMax(). Throws
+     * RankOutOfRangeException if k >= size().
+     */
+    const Object &select(std::size_t k) const {
+        if (k >= size()) {
+            throw RankOutOfRangeException();
+        }
+        const BinaryNode *t = root;
+        while (true) {
+            std::size_t leftSize = sizeOf(t->left);
+            if (k < leftSize) {
+                t = t->left;
+            } else if (k < leftSize + multiplicity(t)) {
+                return t->element;
+            } else {
+                k -= leftSize + multiplicity(t);
+                t = t->right;
+            }
+        }
+    }
+
+    /**
+     * @brief the number of elements from lo to hi, both included
+     */
+    std::size_t count_range(const Object &lo, const Object &hi) const {
+        if (comparator(hi, lo)) {
+            return 0;
+        }
+        return rankAfter(hi) - rank(lo);
+    }
+
+    /**
+     * @brief number of edges on the longest path from the root, -1 for an empty tree
+     * @details depth first with an explicit stack of the right subtrees still to visit
+     */
+    int height() const {
+        int maxDepth = -1;
+        std::vector<std::pair<const BinaryNode *, int>> pending;
+        if (root != nullptr) {
+            pending.emplace_back(root, 0);
+        }
+        while (!pending.empty()) {
+            const BinaryNode *t = pending.back().first;
+            int depth = pending.back().second;
+            pending.pop_back();
+            for (; t != nullptr; t = t->left, ++depth) {
+                maxDepth = std::max(maxDepth, depth);
+                if (t->right != nullptr) {
+                    pending.emplace_back(t->right, depth + 1);
+                }
+            }
+        }
+        return maxDepth;
+    }
+
+    void printTree() {
+        printTree("", root, false);
+    }
+
+    /**
+     * @details nodes with nothing to destroy in a pool that can drop them all at once are
+     * not visited at all
+     */
+    void makeEmpty() {
+        if (NodePool::BulkRelease && std::is_trivially_destructible<BinaryNode>::value) {
+            root = nullptr;
+        } else {
+            makeEmpty(root);
+        }
+        nodes.release();
+    }
+
+    /**
+     * @brief move every node to a fresh pool, in the given order
+     * @details with SlabAllocation the new nodes are consecutive in memory, so the order
+     * is the memory layout, and the free list and any half empty slabs left by removes are
+     * gone. The tree's shape does not change.
+     *
+     * Every node is first copied with its old children, and the old node's left field is
+     * overwritten to point at its copy. A second pass then follows those forwarding
+     * pointers to link the copies to each other.
+     */
+    void compact(NodeLayout layout = NodeLayout::BreadthFirst) {
+        if (root == nullptr) {
+            return;
+        }
+        std::vector<BinaryNode *> order;
+        if (layout == NodeLayout::BreadthFirst) {
+            breadthFirstOrder(order);
+        } else {
+            vanEmdeBoasOrder(root, height() + 1, order);
+        }
+
+        NodePool fresh;
+        std::vector<BinaryNode *> copies;
+        copies.reserve(order.size());
+        for (BinaryNode *t : order) {
+            copies.push_back(fresh.create(std::move(*t), t->left, t->right));
+            t->left = copies.back();
+        }
+        for (BinaryNode *copy : copies) {
+            if (copy->left != nullptr) {
+                copy->left = copy->left->left;
+                copy->left->parent = copy;
+            }
+            if (copy->right != nullptr) {
+                copy->right = copy->right->left;
+                copy->right->parent = copy;
+            }
+        }
+        root = root->left;
+
+        for (BinaryNode *t : order) {
+            nodes.destroy(t);
+        }
+        nodes.release();
+        nodes.swap(fresh);
+    }
+
+    /**
+     * @brief an immutable copy of the elements for lookups only, see FrozenSearchTree.h
+     * @details each element appears once, whatever its freq
+     */
+    FrozenSearchTree<Object, Comparator> freeze() const {
+        std::vector<Object> sorted;
+        forEachInOrder(root, [&sorted](const BinaryNode *t) {
+            sorted.push_back(t->element);
+        });
+        return FrozenSearchTree<Object, Comparator>(sorted, comparator);
+    }
+
+    void insert(const Object &x) {
+        insertNode(x);
+    }
+
+    void insert(Object &&x) {
+        insertNode(std::move(x));
+    }
+
+    /**
+     * @details When both left and right are both non-null, node t is replaced by the
+     * lowest node from the right tree. This works because the structure of the binary
+     * search tree ensures that the minimum node in the right tree is the next largest
+     * value after t's. That node has no left child, so either way the node we unlink has
+     * at most one child, which takes its place. The successor node itself then takes t's
+     * place, children, size and balance data, rather than handing its element up to t,
+     * so only iterators to x are invalidated, as with std::set.
+     *
+     * All of x's duplicates go with it. The subtree sizes are brought down on the way, so
+     * the node is looked up first to know by how much.
+     */
+    void remove(const Object &x) {
+        const BinaryNode *target = find(x);
+        if (target == nullptr) {
+            return; // not found
+        }
+        std::size_t removed = multiplicity(target);
+
+        Step path[Balance::MaxPathLength + 1];
+        std::size_t depth = 0;
+        BinaryNode **link = &root;
+        while (true) {
+            BinaryNode *t = *link;
+            t->size -= removed;
+            if (comparator(x, t->element)) {
+                link = descend(path, depth, link, true);
+            } else if (comparator(t->element, x)) {
+                link = descend(path, depth, link, false);
+            } else {
+                break;
+            }
+        }
+
+        BinaryNode *t = *link;
+        BinaryNode **targetLink = link;
+        if (t->left != nullptr && t->right != nullptr) {
+            // the successor's elements move up to t's place, so only the nodes in between
+            // lose them
+            std::size_t moved = multiplicity(findMin(t->right));
+            link = descend(path, depth, link, false);
+            while ((*link)->left != nullptr) {
+                (*link)->size -= moved;
+                link = descend(path, depth, link, true);
+            }
+        }
+
+        BinaryNode *oldNode = *link;
+        *link = (oldNode->left != nullptr) ? oldNode->left : oldNode->right;
+        if (*link != nullptr) {
+            (*link)->parent = oldNode->parent;
+        }
+        bool shorter = Balance::afterUnlink(oldNode, *link);
+        if (oldNode != t) {
+            spliceInto(oldNode, t, targetLink, path, depth);
+        }
+        nodes.destroy(t);
+        while (depth > 0) {
+            --depth;
+            shorter = Balance::afterRemove(*path[depth].link, path[depth].fromLeft, shorter);
+        }
+    }
+
+    /**
+     * @brief bidirectional iterator over the elements in increasing order
+     * @details elements are read only, changing one could break the ordering. As with
+     * std::set, it stays valid until its own element is removed: removing an element
+     * relinks the nodes around it but does not move any other element to another node.
+     */
+    class const_iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef Object value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Object *pointer;
+        typedef const Object &reference;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return node->element;
+        }
+
+        pointer operator->() const {
+            return &node->element;
+        }
+
+        const_iterator &operator++() {
+            node = successor(node);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        // end() steps back to the largest element
+        const_iterator &operator--() {
+            node = node == nullptr ? tree->findMax(tree->root) : predecessor(node);
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator before = *this;
+            --*this;
+            return before;
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return node == rhs.node;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return node != rhs.node;
+        }
+
+    private:
+        friend class BinarySearchTree;
+
+        const_iterator(const BinaryNode *node, const BinarySearchTree *tree)
+                : node(node), tree(tree) {}
+
+        const BinaryNode *node = nullptr;   // nullptr for end()
+        const BinarySearchTree *tree = nullptr;
+    };
+
+    typedef const_iterator iterator;
+
+    const_iterator begin() const {
+        return const_iterator(findMin(root), this);
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr, this);
+    }
+
+    /**
+     * @brief the first element not less than x, end() if there is none
+     */
+    const_iterator lower_bound(const Object &x) const {
+        return const_iterator(lowerBoundNode(x), this);
+    }
+
+    /**
+     * @brief the first element greater than x, end() if there is none
+     */
+    const_iterator upper_bound(const Object &x) const {
+        const BinaryNode *bound = nullptr;
+        for (const BinaryNode *t = root; t != nullptr;) {
+            if (comparator(x, t->element)) {
+                bound = t;
+                t = t->left;
+            } else {
+                t = t->right;
+            }
+        }
+        return const_iterator(bound, this);
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Object &x) const {
+        return std::make_pair(lower_bound(x), upper_bound(x));
+    }
+
+    /**
+     * @brief call fn on every element from lo to hi, both included, in order
+     * @details the same walk as iterating from lower_bound(lo), without an iterator to
+     * compare against end() at every step
+     */
+    template<typename Fn>
+    void for_each_in_range(const Object &lo, const Object &hi, Fn fn) const {
+        for (const BinaryNode *t = lowerBoundNode(lo); t != nullptr && !comparator(hi, t->element);
+             t = successor(t)) {
+            fn(t->element);
+        }
+    }
+
+    class RankOutOfRangeException {
+    };
+
+    class NotSortedException {
+    };
+
+private:
+
+    /**
+     * @brief the balancing policy's bookkeeping (height, colour) is a base class, so the
+     * unbalanced tree's empty NodeData takes no space
+     */
+    struct BinaryNode : public Balance::NodeData {
+        Object element;
+        BinaryNode *left;
+        BinaryNode *right;
+        BinaryNode *parent = nullptr; // nullptr for the root, for the iterators
+        int freq = 0; // counter for frequency of occurrences of element in tree
+        std::size_t size = 1; // elements in this subtree, counting freq
+
+        BinaryNode(const Object &theElement, BinaryNode *lt, BinaryNode *rt)
+                : element{theElement}, left{lt}, right{rt} {}
+
+        BinaryNode(Object &&theElement, BinaryNode *lt, BinaryNode *rt)
+                : element{std::move(theElement)}, left{lt}, right{rt} {}
+
+        // copy of other's element and bookkeeping with new children, for clone
+        BinaryNode(const BinaryNode &other, BinaryNode *lt, BinaryNode *rt)
+                : Balance::NodeData(other), element{other.element}, left{lt}, right{rt}, freq{other.freq},
+                  size{other.size} {}
+
+        // the same, moving the element, for compact
+        BinaryNode(BinaryNode &&other, BinaryNode *lt, BinaryNode *rt)
+                : Balance::NodeData(other), element{std::move(other.element)}, left{lt}, right{rt},
+                  freq{other.freq}, size{other.size} {}
+
+        // called after a rotation changed the children
+        void refresh() {
+            size = freq + 1 + sizeOf(left) + sizeOf(right);
+            if (left != nullptr) {
+                left->parent = this;
+            }
+            if (right != nullptr) {
+                right->parent = this;
+            }
+            Balance::refresh(this);
+        }
+    };
+
+    /**
+     * @brief a link on the way down, and whether the walk went on to its node's left
+     * @details only recorded for balanced trees, whose height is bounded, so the path fits
+     * in an array on the stack. The policy then visits the links bottom up, as the
+     * recursion unwinding used to.
+     */
+    struct Step {
+        BinaryNode **link;
+        bool fromLeft;
+    };
+
+    typedef typename Allocation::template Pool<BinaryNode> NodePool;
+
+    BinaryNode *root = nullptr;
+    Comparator comparator;
+    NodePool nodes;
+
+    BinaryNode **descend(Step *path, std::size_t &depth, BinaryNode **link, bool toLeft) {
+        if (Balance::MaxPathLength > 0) {
+            path[depth++] = Step{link, toLeft};
+        }
+        return toLeft ? &(*link)->left : &(*link)->right;
+    }
+
+    /**
+     * @brief put successor, already unlinked, in t's place under *link
+     * @details it takes t's children, parent, size and balance data. The path down went
+     * through t's right link, which now belongs to successor.
+     */
+    static void spliceInto(BinaryNode *successor, BinaryNode *t, BinaryNode **link, Step *path,
+                           std::size_t depth) {
+        static_cast<typename Balance::NodeData &>(*successor) = *t;
+        successor->left = t->left;
+        successor->right = t->right;
+        successor->parent = t->parent;
+        successor->size = t->size;
+        if (successor->left != nullptr) {
+            successor->left->parent = successor;
+        }
+        if (successor->right != nullptr) {
+            successor->right->parent = successor;
+        }
+        *link = successor;
+        for (std::size_t i = 0; i < depth; i++) {
+            if (path[i].link == &t->right) {
+                path[i].link = &successor->right;
+            }
+        }
+    }
+
+    // as std::move_if_noexcept, but moving back must not throw either, for merge's undo
+    static const bool MergeMoves = (std::is_nothrow_move_constructible<Object>::value &&
+                                    std::is_nothrow_move_assignable<Object>::value) ||
+                                   !std::is_copy_constructible<Object>::value;
+
+    static typename std::conditional<MergeMoves, Object &&, const Object &>::type takeElement(Object &x) {
+        return std::move(x);
+    }
+
+    static std::size_t sizeOf(const BinaryNode *t) {
+        return t == nullptr ? 0 : t->size;
+    }
+
+    static std::size_t multiplicity(const BinaryNode *t) {
+        return t->freq + 1;
+    }
+
+    const BinaryNode *find(const Object &x) const {
+        const BinaryNode *t = root;
+        while (t != nullptr) {
+            if (comparator(x, t->element)) {
+                // in a binary search tree, everything less than t is to its left
+                t = t->left;
+            } else if (comparator(t->element, x)) {
+                t = t->right;
+            } else {
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    const BinaryNode *lowerBoundNode(const Object &x) const {
+        const BinaryNode *bound = nullptr;
+        for (const BinaryNode *t = root; t != nullptr;) {
+            if (comparator(t->element, x)) {
+                t = t->right;
+            } else {
+                bound = t;
+                t = t->left;
+            }
+        }
+        return bound;
+    }
+
+    static const BinaryNode *successor(const BinaryNode *t) {
+        if (t->right != nullptr) {
+            t = t->right;
+            while (t->left != nullptr) {
+                t = t->left;
+            }
+            return t;
+        }
+        while (t->parent != nullptr && t == t->parent->right) {
+            t = t->parent;
+        }
+        return t->parent;
+    }
+
+    static const BinaryNode *predecessor(const BinaryNode *t) {
+        if (t->left != nullptr) {
+            t = t->left;
+            while (t->right != nullptr) {
+                t = t->right;
+            }
+            return t;
+        }
+        while (t->parent != nullptr && t == t->parent->left) {
+            t = t->parent;
+        }
+        return t->parent;
+    }
+
+    // the number of elements not greater than x
+    std::size_t rankAfter(const Object &x) const {
+        std::size_t notGreater = 0;
+        for (const BinaryNode *t = root; t != nullptr;) {
+            if (comparator(x, t->element)) {
+                t = t->left;
+            } else {
+                notGreater += sizeOf(t->left) + multiplicity(t);
+                t = t->right;
+            }
+        }
+        return notGreater;
+    }
+
+    template<typename X>
+    void insertNode(X &&x) {
+        Step path[Balance::MaxPathLength + 1];
+        std::size_t depth = 0;
+        BinaryNode **link = &root;
+        BinaryNode *parent = nullptr;
+        while (*link != nullptr) {
+            BinaryNode *t = *link;
+            parent = t;
+            t->size++;
+            if (comparator(x, t->element)) {
+                link = descend(path, depth, link, true);
+            } else if (comparator(t->element, x)) {
+                link = descend(path, depth, link, false);
+            } else {
+                // duplicate.
+                t->freq++;
+                return;
+            }
+        }
+        *link = nodes.create(std::forward<X>(x), nullptr, nullptr);
+        (*link)->parent = parent;
+        while (depth > 0) {
+            Balance::afterInsert(*path[--depth].link);
+        }
+        Balance::finishInsert(root);
+    }
+
+    /**
+     * @brief returns true if there is a node in @param t
+     * that has item @param x.
+     */
+    bool contains(const Object &x, const BinaryNode *t) const {
+        // leaf nodes have a nullptr for both left and right
+        // if we hit one, x is not in subtree t.
+        if (t == nullptr) {
+            return false;
+        } else if (comparator(x, t->element)) {
+            /**
+             * When x is less than the value of the current T
+             * call contains again with the node to the left.
+             * Recall that in a binary search tree,
+             * nodes are arranged such that left is less than
+             * t which is less than right.
+             */
+            return contains(x, t->left);
+        } else if (comparator(t->element, x)) {
+            /**
+             * When x is greater than the value of current t,
+             * we call contains again to check the value right
+             * against x.
+             *
+             * Obviously, x must implement the comparison operators.
+             */
+            return contains(x, t->right);
+        } else {
+            // if x is not less than or greater than the value of t,
+            // then it is equal.
+            return true;
+        }
+    }
+
+    /**
+     * @brief find the smallest value in the tree
+     * @details keep traversing left
+     */
+    BinaryNode *findMin(BinaryNode *t) const {
+        if (t != nullptr) {
+            while (t->left != nullptr) {
+                t = t->left;
+            }
+        }
+        return t;
+    }
+
+    BinaryNode *findMax(BinaryNode *t) const {
+        if (t != nullptr) {
+            while (t->right != nullptr) {
+                t = t->right;
+            }
+        }
+        return t;
+    }
+
+    /**
+     * @brief delete every node in O(1) extra space
+     * @details while t has a left child, rotate it up, so the tree leans further right
+     * and no node is lost. Once t has no left child it can be deleted and its right
+     * subtree takes its place. Every rotation moves one node off the leftmost path for
+     * good, so this is O(n).
+     */
+    void makeEmpty(BinaryNode *&t) {
+        while (t != nullptr) {
+            if (t->left != nullptr) {
+                BinaryNode *leftChild = t->left;
+                t->left = leftChild->right;
+                leftChild->right = t;
+                t = leftChild;
+            } else {
+                BinaryNode *oldNode = t;
+                t = t->right;
+                nodes.destroy(oldNode);
+            }
+        }
+    }
+
+    /**
+     * @brief call fn on every node of t's subtree in increasing order of element
+     * @details the stack holds the nodes whose left subtree is being visited. Node is
+     * BinaryNode or const BinaryNode.
+     */
+    template<typename Node, typename Fn>
+    static void forEachInOrder(Node *t, Fn fn) {
+        std::vector<Node *> stack;
+        while (t != nullptr || !stack.empty()) {
+            for (; t != nullptr; t = t->left) {
+                stack.push_back(t);
+            }
+            t = stack.back();
+            stack.pop_back();
+            fn(t);
+            t = t->right;
+        }
+    }
+
+    /**
+     * @brief link up nodes, in increasing order, into a perfectly balanced tree
+     */
+    BinaryNode *build(const std::vector<BinaryNode *> &inOrder) {
+        if (inOrder.empty()) {
+            return nullptr;
+        }
+        std::size_t deepest = 0;
+        while ((std::size_t{2} << deepest) <= inOrder.size()) {
+            deepest++;
+        }
+        BinaryNode *t = createBst(inOrder, 0, inOrder.size() - 1, 0, deepest);
+        t->parent = nullptr;
+        return t;
+    }
+
+    /**
+     * @brief createBst from 4.2_minimal_tree.cpp, on the nodes from start to end, both
+     * included
+     * @details the halves on either side of the middle differ by at most one node, so
+     * every level is full except the deepest, and the recursion is only log2(n) deep. The
+     * subtrees are finished first, so refresh sets the node's size, height and children's
+     * parent.
+     */
+    BinaryNode *createBst(const std::vector<BinaryNode *> &inOrder, std::size_t start, std::size_t end,
+                          std::size_t depth, std::size_t deepest) {
+        std::size_t ind = start + (end - start) / 2;
+        BinaryNode *t = inOrder[ind];
+        t->left = ind > start ? createBst(inOrder, start, ind - 1, depth + 1, deepest) : nullptr;
+        t->right = ind < end ? createBst(inOrder, ind + 1, end, depth + 1, deepest) : nullptr;
+        t->refresh();
+        Balance::afterBuild(t, depth, deepest);
+        return t;
+    }
+
+    /**
+     * @brief the nodes level by level, each level from left to right
+     */
+    void breadthFirstOrder(std::vector<BinaryNode *> &order) {
+        order.push_back(root);
+        for (std::size_t i = 0; i < order.size(); i++) {
+            if (order[i]->left != nullptr) {
+                order.push_back(order[i]->left);
+            }
+            if (order[i]->right != nullptr) {
+                order.push_back(order[i]->right);
+            }
+        }
+    }
+
+    /**
+     * @brief the nodes of the top levels of t's subtree in van Emde Boas order
+     * @details the top half of the levels first, then the subtrees hanging below them
+     * from left to right, every part split again until it is a single level. The
+     * recursion halves levels each time, so it is only log2(height) deep.
+     */
+    void vanEmdeBoasOrder(BinaryNode *t, int levels, std::vector<BinaryNode *> &order) {
+        if (levels == 1) {
+            order.push_back(t);
+            return;
+        }
+        int topLevels = levels / 2;
+        vanEmdeBoasOrder(t, topLevels, order);
+
+        // the roots of the bottom subtrees, topLevels below t
+        std::vector<BinaryNode *> frontier{t};
+        std::vector<BinaryNode *> next;
+        for (int level = 0; level < topLevels; level++) {
+            next.clear();
+            for (BinaryNode *node : frontier) {
+                if (node->left != nullptr) {
+                    next.push_back(node->left);
+                }
+                if (node->right != nullptr) {
+                    next.push_back(node->right);
+                }
+            }
+            frontier.swap(next);
+        }
+        for (BinaryNode *bottom : frontier) {
+            vanEmdeBoasOrder(bottom, levels - topLevels, order);
+        }
+    }
+
+    void printTree(const std::string &prefix, const BinaryNode *node, bool isLeft) {
+        if (node != nullptr) {
+            std::cout << prefix;
+
+            std::cout << (isLeft ? "├──" : "└──");
+
+            // print the value of the node
+            std::cout << node->element << std::endl;
+
+            // enter the next tree level - left and right branch
+            printTree(prefix + (isLeft ? "│   " : "    "), node->left, true);
+            printTree(prefix + (isLeft ? "│   " : "    "), node->right, false);
+        }
+    }
+
+    /**
+     * @brief copy the subtree t, in preorder
+     * @details e.g.
+     *     50
+     *  38    55
+     * We copy 50 and then walk down its left side, copying 38 as the left child of the
+     * copy of 50. Every right subtree we pass, 55 here, is pushed with the copy it has to
+     * be attached to as a right child, and copied when the walk down the left ends. The
+     * stack holds at most one entry per level, on the heap, so deep trees are fine.
+     */
+    BinaryNode *clone(const BinaryNode *t) {
+        BinaryNode *copy = nullptr;
+        std::vector<std::pair<const BinaryNode *, BinaryNode *>> pending;
+        if (t != nullptr) {
+            pending.emplace_back(t, nullptr);
+        }
+        while (!pending.empty()) {
+            const BinaryNode *source = pending.back().first;
+            BinaryNode *parent = pending.back().second;
+            pending.pop_back();
+            BinaryNode **link = parent == nullptr ? &copy : &parent->right;
+            for (; source != nullptr; source = source->left) {
+                *link = nodes.create(*source, nullptr, nullptr);
+                (*link)->parent = parent;
+                if (source->right != nullptr) {
+                    pending.emplace_back(source->right, *link);
+                }
+                parent = *link;
+                link = &parent->left;
+            }
+        }
+        return copy;
+    }
+
+};
+
+#endif //CRACKINGTHECODINGINTERVIEW_BINARYSEARCHTREE_H
@@ -0,0 +1,279 @@
+/**
+ * Benchmarks for BinarySearchTree:
+ *  - every balancing policy against std::set, with keys inserted in sorted, reverse and
+ *    random order, then looked up and removed in random order
+ *  - the iterative lookup against the recursive one, and copying and destroying trees
+ *  - nodes from the heap against nodes from slabs, before and after compaction, with the
+ *    resident memory the tree added
+ *  - the frozen Eytzinger array against the tree it was frozen from and binary search in a
+ *    sorted vector, from trees that fit in L1 to trees far larger than the last level cache
+ *  - range scans with for_each_in_range and with iterators, against std::set
+ *  - fromSorted and merge against repeated insert
+ *
+ * usage: BinarySearchTreeBenchmark [maxKeys], 10^6 keys by default
+ */
+
+#include "BinarySearchTree.h"
+#include "TreeBenchmark.h"
+
+/**
+ * [benchmarkBalancing - the plain tree degrades to a list on sorted keys, so building it is
+ * O(n^2) and it only gets 10^4 of them]
+ */
+void benchmarkBalancing(std::size_t maxKeys) {
+    for (std::size_t n : benchmarkSizes(maxKeys)) {
+        for (KeyOrder order : {KeyOrder::Sorted, KeyOrder::Reverse, KeyOrder::Random}) {
+            if (order == KeyOrder::Random || n <= 10000) {
+                benchmarkTree<BinarySearchTree<int>>("Unbalanced", n, order);
+            }
+            benchmarkTree<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n, order);
+            benchmarkTree<BinarySearchTree<int, std::less<int>, RedBlackBalance>>("RedBlack", n, order);
+            benchmarkTree<StdSet<int>>("std::set", n, order);
+        }
+    }
+}
+
+template<typename Tree>
+void benchmarkLookups(const std::string &name, std::size_t n, KeyOrder order) {
+    std::vector<int> probes = generateKeys(n, KeyOrder::Random, 2);
+    std::string prefix = name + " " + keyOrderName(order);
+    Tree tree;
+    for (int key : generateKeys(n, order)) {
+        tree.insert(key);
+    }
+
+    reportNsPerOp(prefix + " contains", n, timeNs([&] {
+        std::size_t found = 0;
+        for (int key : probes) {
+            found += tree.contains(key);
+        }
+        consume(found);
+    }));
+    reportNsPerOp(prefix + " containsRecursive", n, timeNs([&] {
+        std::size_t found = 0;
+        for (int key : probes) {
+            found += tree.containsRecursive(key);
+        }
+        consume(found);
+    }));
+    reportNsPerOp(prefix + " clone", n, timeNs([&] {
+        Tree copy = tree;
+        consume(copy.findMin());
+    }));
+    reportNsPerOp(prefix + " makeEmpty", n, timeNs([&] {
+        tree.makeEmpty();
+    }));
+}
+
+/**
+ * [benchmarkRecursion - the unbalanced tree on sorted keys is a path, which only the
+ * iterative walks can handle beyond some 10^5 keys. Building it is O(n^2), so it gets
+ * 10^4 keys.]
+ */
+void benchmarkRecursion(std::size_t maxKeys) {
+    for (std::size_t n : benchmarkSizes(maxKeys)) {
+        benchmarkLookups<BinarySearchTree<int>>("Unbalanced", n, KeyOrder::Random);
+        benchmarkLookups<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n, KeyOrder::Random);
+    }
+    benchmarkLookups<BinarySearchTree<int>>("Unbalanced", std::min<std::size_t>(maxKeys, 10000), KeyOrder::Sorted);
+}
+
+/**
+ * [benchmarkNodes - insert n random keys, then look them up as inserted and after each
+ * compaction]
+ */
+template<typename Tree>
+void benchmarkNodes(const std::string &name, std::size_t n) {
+    std::vector<int> keys = generateKeys(n, KeyOrder::Random);
+    std::vector<int> probes = generateKeys(n, KeyOrder::Random, 2);
+    Tree tree;
+    auto lookups = [&] {
+        std::size_t found = 0;
+        for (int key : probes) {
+            found += tree.contains(key);
+        }
+        consume(found);
+    };
+
+    // as a double: the resident set can shrink between the samples, and a size_t
+    // difference would wrap
+    double before = static_cast<double>(residentBytes());
+    reportNsPerOp(name + " insert", n, timeNs([&] {
+        for (int key : keys) {
+            tree.insert(key);
+        }
+    }));
+    reportBytesPerKey(name + " resident", n, static_cast<double>(residentBytes()) - before);
+    reportNsPerOp(name + " contains", n, timeNs(lookups));
+    tree.compact(NodeLayout::BreadthFirst);
+    reportNsPerOp(name + " contains, bfs", n, timeNs(lookups));
+    tree.compact(NodeLayout::VanEmdeBoas);
+    reportNsPerOp(name + " contains, veb", n, timeNs(lookups));
+    reportNsPerOp(name + " makeEmpty", n, timeNs([&] {
+        tree.makeEmpty();
+    }));
+}
+
+void benchmarkAllocation(std::size_t maxKeys) {
+    for (std::size_t n : benchmarkSizes(maxKeys)) {
+        benchmarkNodes<BinarySearchTree<int>>("Unbalanced heap", n);
+        benchmarkNodes<BinarySearchTree<int, std::less<int>, Unbalanced, SlabAllocation<>>>("Unbalanced slab", n);
+        benchmarkNodes<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL heap", n);
+        benchmarkNodes<BinarySearchTree<int, std::less<int>, AvlBalance, SlabAllocation<>>>("AVL slab", n);
+    }
+}
+
+/**
+ * [benchmarkFrozen - lookups of n random probes, half of them misses]
+ */
+void benchmarkFrozen(std::size_t maxKeys) {
+    for (std::size_t n : benchmarkSizes(maxKeys)) {
+        std::vector<int> keys = generateKeys(n, KeyOrder::Random);
+        std::vector<int> probes = generateKeys(2 * n, KeyOrder::Random, 2);
+        probes.resize(n);
+        BinarySearchTree<int, std::less<int>, AvlBalance, SlabAllocation<>> tree;
+        for (int key : keys) {
+            tree.insert(key);
+        }
+        tree.compact(NodeLayout::VanEmdeBoas);
+        FrozenSearchTree<int> frozen = tree.freeze();
+        std::vector<int> sorted = generateKeys(n, KeyOrder::Sorted);
+
+        reportNsPerOp("AVL slab veb contains", n, timeNs([&] {
+            std::size_t found = 0;
+            for (int key : probes) {
+                found += tree.contains(key);
+            }
+            consume(found);
+        }));
+        reportNsPerOp("sorted vector binary_search", n, timeNs([&] {
+            std::size_t found = 0;
+            for (int key : probes) {
+                found += std::binary_search(sorted.begin(), sorted.end(), key);
+            }
+            consume(found);
+        }));
+        reportNsPerOp("frozen contains", n, timeNs([&] {
+            std::size_t found = 0;
+            for (int key : probes) {
+                found += frozen.contains(key);
+            }
+            consume(found);
+        }));
+        reportNsPerOp("frozen lower_bound", n, timeNs([&] {
+            std::uintptr_t sum = 0;
+            for (int key : probes) {
+                const int *bound = frozen.lower_bound(key);
+                sum += bound == nullptr ? 0 : *bound;
+            }
+            consume(sum);
+        }));
+        reportNsPerOp("frozen rank", n, timeNs([&] {
+            std::size_t sum = 0;
+            for (int key : probes) {
+                sum += frozen.rank(key);
+            }
+            consume(sum);
+        }));
+    }
+}
+
+/**
+ * [benchmarkIteratorScan - the scans of benchmarkScan, with lower_bound and ++]
+ */
+template<typename Tree>
+void benchmarkIteratorScan(const std::string &name, std::size_t n) {
+    const int width = 100;
+    std::vector<int> starts = generateKeys(n, KeyOrder::Random, 2);
+    starts.resize(n / width);
+    Tree tree;
+    for (int key : generateKeys(n, KeyOrder::Random)) {
+        tree.insert(key);
+    }
+
+    reportNsPerOp(name + " iterator scan, per key", n, timeNs([&] {
+        std::uintptr_t sum = 0;
+        for (int start : starts) {
+            for (auto it = tree.lower_bound(start); it != tree.end() && *it < start + width; ++it) {
+                sum += *it;
+            }
+        }
+        consume(sum);
+    }));
+}
+
+void benchmarkScans(std::size_t maxKeys) {
+    for (std::size_t n : benchmarkSizes(maxKeys)) {
+        benchmarkScan<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n);
+        benchmarkIteratorScan<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n);
+        benchmarkScan<StdSet<int>>("std::set", n);
+    }
+}
+
+/**
+ * [benchmarkFromSorted - build a tree of n sorted keys with insert and with fromSorted]
+ */
+template<typename Tree>
+void benchmarkFromSorted(const std::string &name, std::size_t n, bool repeatedInsert) {
+    std::vector<int> keys = generateKeys(n, KeyOrder::Sorted);
+    if (repeatedInsert) {
+        reportNsPerOp(name + " insert sorted", n, timeNs([&] {
+            Tree tree;
+            for (int key : keys) {
+                tree.insert(key);
+            }
+            consume(tree.height());
+        }));
+    }
+    reportNsPerOp(name + " fromSorted", n, timeNs([&] {
+        Tree tree = Tree::fromSorted(keys);
+        consume(tree.height());
+    }));
+}
+
+/**
+ * [benchmarkMerge - two trees of n / 2 random keys each, the odd and the even ones, merged
+ * with merge and by inserting one's elements into the other]
+ */
+template<typename Tree>
+void benchmarkMerge(const std::string &name, std::size_t n) {
+    Tree evens;
+    Tree odds;
+    for (int key : generateKeys(n, KeyOrder::Random)) {
+        (key % 2 == 0 ? evens : odds).insert(key);
+    }
+
+    Tree target = evens;
+    reportNsPerOp(name + " insert all of other", n, timeNs([&] {
+        for (int key : odds) {
+            target.insert(key);
+        }
+    }));
+    target = evens;
+    Tree other = odds;
+    reportNsPerOp(name + " merge", n, timeNs([&] {
+        target.merge(other);
+    }));
+}
+
+void benchmarkBulkLoad(std::size_t maxKeys) {
+    for (std::size_t n : benchmarkSizes(maxKeys)) {
+        benchmarkFromSorted<BinarySearchTree<int>>("Unbalanced", n, n <= 10000);
+        benchmarkFromSorted<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n, true);
+        benchmarkFromSorted<BinarySearchTree<int, std::less<int>, RedBlackBalance>>("RedBlack", n, true);
+        benchmarkFromSorted<BinarySearchTree<int, std::less<int>, AvlBalance, SlabAllocation<>>>("AVL slab", n, true);
+        benchmarkMerge<BinarySearchTree<int, std::less<int>, AvlBalance>>("AVL", n);
+        benchmarkMerge<BinarySearchTree<int, std::less<int>, AvlBalance, SlabAllocation<>>>("AVL slab", n);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::size_t maxKeys = benchmarkMaxKeys(argc, argv, 1000000);
+    benchmarkBalancing(maxKeys);
+    benchmarkRecursion(maxKeys);
+    benchmarkAllocation(maxKeys);
+    benchmarkFrozen(maxKeys);
+    benchmarkScans(maxKeys);
+    benchmarkBulkLoad(maxKeys);
+    return 0;
+}
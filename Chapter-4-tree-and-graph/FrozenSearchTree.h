@@ -0,0 +1,143 @@
+/**
+ * An immutable search tree in one array, for sets that are built once and then only
+ * looked up. BinarySearchTree::freeze makes one.
+ */
+
+#ifndef CRACKINGTHECODINGINTERVIEW_FROZENSEARCHTREE_H
+#define CRACKINGTHECODINGINTERVIEW_FROZENSEARCHTREE_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief sorted distinct elements in Eytzinger (breadth first) order
+ * @details slot 1 holds the root and slot k has its children in 2k and 2k + 1, so there
+ * are no pointers, and the first levels of every lookup share a few cache lines.
+ *
+ * A lookup walks down with k = 2k + (element < x), which compiles to a conditional move
+ * rather than a branch the CPU would mispredict half the time. The walk touches one new
+ * cache line per level once it is past the top, so it prefetches k's descendants
+ * PrefetchLevels below, which are the consecutive slots from k * 2^PrefetchLevels on and
+ * share a cache line when they are aligned to one. That load is in flight while the walk
+ * compares its way down to it.
+ *
+ * When the walk falls off the bottom, the bits of k record the turns it took. Stripping
+ * the trailing right turns and the last left turn leaves the slot where it last went
+ * left, which is the lower bound.
+ *
+ * Slot 0 is unused, so the array has size() + 1 elements.
+ */
+template<typename Object, typename Comparator=std::less<Object>>
+class FrozenSearchTree {
+public:
+
+    FrozenSearchTree() = default;
+
+    /**
+     * @param sorted distinct elements in increasing order under comparator
+     */
+    explicit FrozenSearchTree(const std::vector<Object> &sorted, Comparator comparator = Comparator())
+            : comparator(comparator) {
+        if (sorted.empty()) {
+            return;
+        }
+        ranks.resize(sorted.size() + 1);
+        std::size_t next = 0;
+        assignRanks(1, next);
+        elements.reserve(sorted.size() + 1);
+        elements.push_back(sorted[0]);
+        for (std::size_t k = 1; k <= sorted.size(); k++) {
+            elements.push_back(sorted[ranks[k]]);
+        }
+    }
+
+    std::size_t size() const {
+        return ranks.empty() ? 0 : ranks.size() - 1;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    bool contains(const Object &x) const {
+        std::size_t k = lowerBoundSlot(x);
+        return k != 0 && !comparator(x, elements[k]);
+    }
+
+    /**
+     * @brief the smallest element not less than x, nullptr if there is none
+     */
+    const Object *lower_bound(const Object &x) const {
+        std::size_t k = lowerBoundSlot(x);
+        return k == 0 ? nullptr : &elements[k];
+    }
+
+    /**
+     * @brief the number of elements less than x
+     */
+    std::size_t rank(const Object &x) const {
+        std::size_t k = lowerBoundSlot(x);
+        return k == 0 ? size() : ranks[k];
+    }
+
+private:
+    // levels whose descendants of one slot still fit in a 64 byte cache line
+    static const std::size_t PrefetchLevels = sizeof(Object) <= 4 ? 4 : sizeof(Object) <= 8 ? 3 :
+                                              sizeof(Object) <= 16 ? 2 : 1;
+
+    /**
+     * @brief the in-order position of every slot, by walking the implicit tree in order
+     * @details it is a complete binary tree, so the recursion is only log2(n) deep
+     */
+    void assignRanks(std::size_t k, std::size_t &next) {
+        if (k >= ranks.size()) {
+            return;
+        }
+        assignRanks(2 * k, next);
+        ranks[k] = next++;
+        assignRanks(2 * k + 1, next);
+    }
+
+    /**
+     * @brief the slot of the smallest element not less than x, 0 if there is none
+     */
+    std::size_t lowerBoundSlot(const Object &x) const {
+        const std::size_t n = size();
+        const Object *base = elements.data();
+        std::size_t k = 1;
+        while (k <= n) {
+            prefetch(base + (k << PrefetchLevels));
+            k = 2 * k + static_cast<std::size_t>(comparator(base[k], x));
+        }
+        return k >> turnsToUndo(k);
+    }
+
+    static void prefetch(const Object *address) {
+#if defined(__GNUC__)
+        __builtin_prefetch(address);
+#else
+        (void) address;
+#endif
+    }
+
+    // the trailing right turns and the left turn before them
+    static std::size_t turnsToUndo(std::size_t k) {
+#if defined(__GNUC__)
+        return __builtin_ffsll(~static_cast<unsigned long long>(k));
+#else
+        std::size_t ones = 1;
+        for (; k & 1; k >>= 1) {
+            ++ones;
+        }
+        return ones;
+#endif
+    }
+
+    std::vector<Object> elements;
+    std::vector<std::size_t> ranks;   // in-order position of every slot
+    Comparator comparator;
+};
+
+#endif //CRACKINGTHECODINGINTERVIEW_FROZENSEARCHTREE_H
@@ -0,0 +1,142 @@
+/**
+ * Node allocation policies for BinarySearchTree.
+ *
+ * A policy has a Pool<Node> template, and every tree owns one pool for its nodes:
+ *
+ *  - create(args...)   construct a node from args, as new Node(args...)
+ *  - destroy(node)     destroy a node from create, as delete node
+ *  - release()         give back all the memory the pool holds. The tree destroys its
+ *                      nodes first, unless BulkRelease is true and they have no destructor
+ *                      to run, in which case it just forgets them
+ *  - swap(other)
+ *
+ * Pools are neither copied nor shared: a copy of a tree builds its own.
+ */
+
+#ifndef CRACKINGTHECODINGINTERVIEW_TREEALLOCATION_H
+#define CRACKINGTHECODINGINTERVIEW_TREEALLOCATION_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief the order BinarySearchTree::compact lays its nodes out in
+ * @details BreadthFirst puts the top levels, which every lookup passes, next to each
+ * other. VanEmdeBoas splits the tree at half its height, lays out the top half and then
+ * each bottom subtree, each of them split the same way, so any path of k levels crosses
+ * O(k / log2(B)) blocks of B nodes whatever B is.
+ */
+enum class NodeLayout {
+    BreadthFirst,
+    VanEmdeBoas
+};
+
+/**
+ * @brief the default: every node is a new and every remove a delete
+ */
+struct HeapAllocation {
+    template<typename Node>
+    class Pool {
+    public:
+        static const bool BulkRelease = false;
+
+        template<typename... Args>
+        Node *create(Args &&... args) {
+            return new Node(std::forward<Args>(args)...);
+        }
+
+        void destroy(Node *node) {
+            delete node;
+        }
+
+        void release() {}
+
+        void swap(Pool &) {}
+    };
+};
+
+/**
+ * @brief nodes are carved out of slabs of SlabBytes, which the pool owns
+ * @details consecutive inserts get neighbouring nodes, instead of whatever the general
+ * purpose heap has free, and there is no per-node malloc header. A removed node goes on
+ * a free list threaded through the slots and is reused by the next insert. The slabs are
+ * only returned by release(), which makeEmpty calls: for trivially destructible elements
+ * that is O(number of slabs) rather than one delete per node.
+ */
+template<std::size_t SlabBytes = 64 * 1024>
+struct SlabAllocation {
+    template<typename Node>
+    class Pool {
+    public:
+        static const bool BulkRelease = true;
+
+        Pool() = default;
+
+        Pool(const Pool &) = delete;
+
+        Pool &operator=(const Pool &) = delete;
+
+        template<typename... Args>
+        Node *create(Args &&... args) {
+            Slot *slot = take();
+            try {
+                return new(slot->storage) Node(std::forward<Args>(args)...);
+            } catch (...) {
+                giveBack(slot);
+                throw;
+            }
+        }
+
+        void destroy(Node *node) {
+            node->~Node();
+            giveBack(reinterpret_cast<Slot *>(node));
+        }
+
+        void release() {
+            slabs.clear();
+            freeList = nullptr;
+            used = SlotsPerSlab;
+        }
+
+        void swap(Pool &other) {
+            slabs.swap(other.slabs);
+            std::swap(freeList, other.freeList);
+            std::swap(used, other.used);
+        }
+
+    private:
+        union Slot {
+            Slot *next;
+            alignas(Node) unsigned char storage[sizeof(Node)];
+        };
+
+        static const std::size_t SlotsPerSlab = SlabBytes / sizeof(Slot) > 0 ? SlabBytes / sizeof(Slot) : 1;
+
+        Slot *take() {
+            if (freeList != nullptr) {
+                Slot *slot = freeList;
+                freeList = slot->next;
+                return slot;
+            }
+            if (used == SlotsPerSlab) {
+                slabs.emplace_back(new Slot[SlotsPerSlab]);
+                used = 0;
+            }
+            return &slabs.back()[used++];
+        }
+
+        void giveBack(Slot *slot) {
+            slot->next = freeList;
+            freeList = slot;
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> slabs;
+        Slot *freeList = nullptr;
+        std::size_t used = SlotsPerSlab;   // slots handed out from the last slab
+    };
+};
+
+#endif //CRACKINGTHECODINGINTERVIEW_TREEALLOCATION_H
@@ -0,0 +1,357 @@
+/**
+ * Balancing policies for BinarySearchTree.
+ *
+ * A policy adds its bookkeeping to every node through NodeData, which BinaryNode derives
+ * from, and is called back by the tree while it walks back up an insert or remove path:
+ *
+ *  - refresh(t)                  recompute t's bookkeeping from its children
+ *  - afterInsert(t)              t is on the insert path, its subtree changed below it
+ *  - afterUnlink(old, t)         old was replaced by its only child t, returns whether the
+ *                                subtree lost height as the policy counts it
+ *  - afterRemove(t, left, lost)  t is on the remove path and its left or right subtree
+ *                                lost height, returns whether t's subtree did
+ *  - finishInsert(root)
+ *  - afterBuild(t, depth, deepest)
+ *                                t was placed at depth in a tree built from sorted elements,
+ *                                whose levels are all full except the deepest. Its
+ *                                subtrees are done and it has been refreshed
+ *
+ * MaxPathLength bounds the number of nodes on a path from the root in any tree the policy
+ * allows, plus the node being inserted. The tree records the path down in an array of
+ * that size, and not at all when it is 0.
+ *
+ * Every callback gets the link to t, so it can rotate t's subtree in place.
+ */
+
+#ifndef CRACKINGTHECODINGINTERVIEW_TREEBALANCING_H
+#define CRACKINGTHECODINGINTERVIEW_TREEBALANCING_H
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief single rotation, k2's left child k1 takes its place
+ * @details the names follow Weiss. k1 takes over k2's parent, and both nodes are
+ * refreshed, lowest first, which also points their children back at them.
+ */
+template<typename Node>
+void rotateWithLeftChild(Node *&k2) {
+    Node *k1 = k2->left;
+    k1->parent = k2->parent;
+    k2->left = k1->right;
+    k1->right = k2;
+    k2->refresh();
+    k1->refresh();
+    k2 = k1;
+}
+
+/**
+ * @brief single rotation, k1's right child k2 takes its place
+ */
+template<typename Node>
+void rotateWithRightChild(Node *&k1) {
+    Node *k2 = k1->right;
+    k2->parent = k1->parent;
+    k1->right = k2->left;
+    k2->left = k1;
+    k1->refresh();
+    k2->refresh();
+    k1 = k2;
+}
+
+/**
+ * @brief double rotation, k3's left child's right child takes its place
+ */
+template<typename Node>
+void doubleWithLeftChild(Node *&k3) {
+    rotateWithRightChild(k3->left);
+    rotateWithLeftChild(k3);
+}
+
+/**
+ * @brief double rotation, k1's right child's left child takes its place
+ */
+template<typename Node>
+void doubleWithRightChild(Node *&k1) {
+    rotateWithLeftChild(k1->right);
+    rotateWithRightChild(k1);
+}
+
+/**
+ * @brief the default: no bookkeeping and no rotations
+ */
+struct Unbalanced {
+    struct NodeData {
+    };
+
+    static const std::size_t MaxPathLength = 0;
+
+    template<typename Node>
+    static void refresh(Node *) {}
+
+    template<typename Node>
+    static void afterInsert(Node *&) {}
+
+    template<typename Node>
+    static bool afterUnlink(Node *, Node *&) {
+        return false;
+    }
+
+    template<typename Node>
+    static bool afterRemove(Node *&, bool, bool) {
+        return false;
+    }
+
+    template<typename Node>
+    static void finishInsert(Node *) {}
+
+    template<typename Node>
+    static void afterBuild(Node *, std::size_t, std::size_t) {}
+};
+
+/**
+ * @brief AVL tree: the heights of the two subtrees of any node differ by at most one
+ * @details every node on the path is balanced on the way back up, as in Weiss, which
+ * keeps the height below 1.44 log2(n).
+ */
+struct AvlBalance {
+    struct NodeData {
+        int height = 0;
+    };
+
+    static const int AllowedImbalance = 1;
+
+    // an AVL tree of height h has at least Fibonacci(h + 3) - 1 nodes, so h < 92
+    static const std::size_t MaxPathLength = 94;
+
+    template<typename Node>
+    static int height(const Node *t) {
+        return t == nullptr ? -1 : t->height;
+    }
+
+    template<typename Node>
+    static void refresh(Node *t) {
+        t->height = std::max(height(t->left), height(t->right)) + 1;
+    }
+
+    template<typename Node>
+    static void afterInsert(Node *&t) {
+        balance(t);
+    }
+
+    template<typename Node>
+    static bool afterUnlink(Node *, Node *&) {
+        return false;
+    }
+
+    template<typename Node>
+    static bool afterRemove(Node *&t, bool, bool) {
+        balance(t);
+        return false;
+    }
+
+    template<typename Node>
+    static void finishInsert(Node *) {}
+
+    // refresh already set the height, and the subtrees differ by at most one node
+    template<typename Node>
+    static void afterBuild(Node *, std::size_t, std::size_t) {}
+
+    /**
+     * @brief restore the AVL property at t, assuming its subtrees are AVL trees
+     */
+    template<typename Node>
+    static void balance(Node *&t) {
+        if (t == nullptr) {
+            return;
+        }
+        if (height(t->left) - height(t->right) > AllowedImbalance) {
+            if (height(t->left->left) >= height(t->left->right)) {
+                rotateWithLeftChild(t);
+            } else {
+                doubleWithLeftChild(t);
+            }
+        } else if (height(t->right) - height(t->left) > AllowedImbalance) {
+            if (height(t->right->right) >= height(t->right->left)) {
+                rotateWithRightChild(t);
+            } else {
+                doubleWithRightChild(t);
+            }
+        } else {
+            refresh(t);
+        }
+    }
+};
+
+/**
+ * @brief red-black tree: no red node has a red child, and every path from a node down to
+ * a nullptr passes the same number of black nodes
+ * @details height below 2 log2(n + 1). It rotates less than AVL on insert and remove, at
+ * the price of a slightly deeper tree for lookups.
+ *
+ * Insert fixes a red child with a red child of its own at the grandparent, bottom up.
+ * Remove reports when a subtree lost a black node, and the parent fixes it with the
+ * sibling as in CLRS.
+ */
+struct RedBlackBalance {
+    struct NodeData {
+        bool red = true;
+    };
+
+    // at most 2 log2(n + 1) edges, so at most 128 for any n that fits in memory
+    static const std::size_t MaxPathLength = 130;
+
+    template<typename Node>
+    static bool isRed(const Node *t) {
+        return t != nullptr && t->red;
+    }
+
+    template<typename Node>
+    static void refresh(Node *) {}
+
+    template<typename Node>
+    static void afterInsert(Node *&t) {
+        if (isRed(t->left) && (isRed(t->left->left) || isRed(t->left->right))) {
+            if (isRed(t->right)) {
+                recolour(t);
+            } else {
+                if (isRed(t->left->right)) {
+                    doubleWithLeftChild(t);
+                } else {
+                    rotateWithLeftChild(t);
+                }
+                t->red = false;
+                t->right->red = true;
+            }
+        } else if (isRed(t->right) && (isRed(t->right->right) || isRed(t->right->left))) {
+            if (isRed(t->left)) {
+                recolour(t);
+            } else {
+                if (isRed(t->right->left)) {
+                    doubleWithRightChild(t);
+                } else {
+                    rotateWithRightChild(t);
+                }
+                t->red = false;
+                t->left->red = true;
+            }
+        }
+    }
+
+    /**
+     * @brief a black node was removed. Its red child, if any, turns black and makes up
+     * for it.
+     */
+    template<typename Node>
+    static bool afterUnlink(Node *old, Node *&t) {
+        if (old->red) {
+            return false;
+        }
+        if (isRed(t)) {
+            t->red = false;
+            return false;
+        }
+        return true;
+    }
+
+    template<typename Node>
+    static bool afterRemove(Node *&t, bool fromLeft, bool lostBlack) {
+        if (!lostBlack) {
+            return false;
+        }
+        return fromLeft ? fixLeftShort(t) : fixRightShort(t);
+    }
+
+    template<typename Node>
+    static void finishInsert(Node *root) {
+        if (root != nullptr) {
+            root->red = false;
+        }
+    }
+
+    /**
+     * @brief every path down passes one node per full level, so those are black, and the
+     * deepest level, which may not be full, is red
+     */
+    template<typename Node>
+    static void afterBuild(Node *t, std::size_t depth, std::size_t deepest) {
+        t->red = depth == deepest && depth > 0;
+    }
+
+private:
+    template<typename Node>
+    static void recolour(Node *t) {
+        t->red = true;
+        t->left->red = false;
+        t->right->red = false;
+    }
+
+    /**
+     * @brief t's left subtree has one black node less than its right subtree
+     * @return [true if t's whole subtree is now one black node short]
+     */
+    template<typename Node>
+    static bool fixLeftShort(Node *&t) {
+        if (t->right->red) {
+            // red sibling: rotate it up, then t is red and the cases below finish it
+            rotateWithRightChild(t);
+            t->red = false;
+            t->left->red = true;
+            fixLeftShort(t->left);
+            return false;
+        }
+        Node *sibling = t->right;
+        if (!isRed(sibling->left) && !isRed(sibling->right)) {
+            sibling->red = true;
+            if (t->red) {
+                t->red = false;
+                return false;
+            }
+            return true;
+        }
+        if (!isRed(sibling->right)) {
+            rotateWithLeftChild(t->right);
+            t->right->red = false;
+            t->right->right->red = true;
+        }
+        bool red = t->red;
+        rotateWithRightChild(t);
+        t->red = red;
+        t->left->red = false;
+        t->right->red = false;
+        return false;
+    }
+
+    template<typename Node>
+    static bool fixRightShort(Node *&t) {
+        if (t->left->red) {
+            rotateWithLeftChild(t);
+            t->red = false;
+            t->right->red = true;
+            fixRightShort(t->right);
+            return false;
+        }
+        Node *sibling = t->left;
+        if (!isRed(sibling->left) && !isRed(sibling->right)) {
+            sibling->red = true;
+            if (t->red) {
+                t->red = false;
+                return false;
+            }
+            return true;
+        }
+        if (!isRed(sibling->left)) {
+            rotateWithRightChild(t->left);
+            t->left->red = false;
+            t->left->left->red = true;
+        }
+        bool red = t->red;
+        rotateWithLeftChild(t);
+        t->red = red;
+        t->left->red = false;
+        t->right->red = false;
+        return false;
+    }
+};
+
+#endif //CRACKINGTHECODINGINTERVIEW_TREEBALANCING_H
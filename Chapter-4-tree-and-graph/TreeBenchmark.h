@@ -0,0 +1,230 @@
+/**
+ * Key generators and timing helpers for the chapter 4 benchmarks.
+ *
+ * Keys are the integers 0 .. n - 1 in sorted, reverse or shuffled order, so every key is
+ * distinct and a lookup of a shuffled key always hits. The shuffle uses a fixed seed so
+ * runs can be compared with each other.
+ */
+
+#ifndef CRACKINGTHECODINGINTERVIEW_TREEBENCHMARK_H
+#define CRACKINGTHECODINGINTERVIEW_TREEBENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <fstream>
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+enum class KeyOrder {
+    Sorted,
+    Reverse,
+    Random
+};
+
+inline const char *keyOrderName(KeyOrder order) {
+    switch (order) {
+        case KeyOrder::Sorted:
+            return "sorted";
+        case KeyOrder::Reverse:
+            return "reverse";
+        default:
+            return "random";
+    }
+}
+
+/**
+ * [generateKeys - the keys 0 .. n - 1 in the given order]
+ */
+inline std::vector<int> generateKeys(std::size_t n, KeyOrder order, unsigned seed = 1) {
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    if (order == KeyOrder::Reverse) {
+        std::reverse(keys.begin(), keys.end());
+    } else if (order == KeyOrder::Random) {
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+    }
+    return keys;
+}
+
+/**
+ * [StdSet - std::set with the BinarySearchTree interface, as the baseline]
+ */
+template<typename Object>
+class StdSet {
+public:
+    void insert(const Object &x) {
+        set.insert(x);
+    }
+
+    void remove(const Object &x) {
+        set.erase(x);
+    }
+
+    bool contains(const Object &x) const {
+        return set.count(x) != 0;
+    }
+
+    const Object &findMin() const {
+        return *set.begin();
+    }
+
+    const Object &findMax() const {
+        return *set.rbegin();
+    }
+
+    template<typename Fn>
+    void for_each_in_range(const Object &lo, const Object &hi, Fn fn) const {
+        for (auto it = set.lower_bound(lo); it != set.end() && !(hi < *it); ++it) {
+            fn(*it);
+        }
+    }
+
+private:
+    std::set<Object> set;
+};
+
+/**
+ * [timeNs - wall clock time of fn in nanoseconds]
+ */
+template<typename Fn>
+double timeNs(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * [consume - keep a benchmark result alive so the work is not optimised away]
+ */
+inline volatile std::uintptr_t &benchmarkSink() {
+    static volatile std::uintptr_t sink = 0;
+    return sink;
+}
+
+inline void consume(std::uintptr_t value) {
+    benchmarkSink() = benchmarkSink() + value;
+}
+
+/**
+ * [reportNsPerOp - print one benchmark line]
+ */
+inline void reportNsPerOp(const std::string &name, std::size_t n, double ns) {
+    std::ostringstream line;
+    line << std::left << std::setw(40) << name << std::right << std::setw(12) << n
+         << std::setw(12) << std::fixed << std::setprecision(2) << ns / n << " ns/op";
+    std::cout << line.str() << std::endl;
+}
+
+/**
+ * [residentBytes - resident set size of the process, 0 where /proc is not available]
+ * @details freed heap memory is handed back to the system first, so that what the last
+ * benchmark freed is not counted
+ */
+inline std::size_t residentBytes() {
+#if defined(__linux__)
+    malloc_trim(0);
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0;
+    std::size_t residentPages = 0;
+    if (statm >> pages >> residentPages) {
+        return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+/**
+ * [reportBytesPerKey - print one memory line]
+ */
+inline void reportBytesPerKey(const std::string &name, std::size_t n, double bytes) {
+    std::ostringstream line;
+    line << std::left << std::setw(40) << name << std::right << std::setw(12) << n
+         << std::setw(12) << std::fixed << std::setprecision(2) << bytes / n << " B/key";
+    std::cout << line.str() << std::endl;
+}
+
+/**
+ * [benchmarkTree - insert n keys in the given order, then look up and remove them all]
+ */
+template<typename Tree>
+void benchmarkTree(const std::string &name, std::size_t n, KeyOrder order) {
+    std::vector<int> keys = generateKeys(n, order);
+    std::vector<int> probes = generateKeys(n, KeyOrder::Random, 2);
+    std::string prefix = name + " " + keyOrderName(order);
+    Tree tree;
+
+    reportNsPerOp(prefix + " insert", n, timeNs([&] {
+        for (int key : keys) {
+            tree.insert(key);
+        }
+    }));
+    reportNsPerOp(prefix + " contains", n, timeNs([&] {
+        std::size_t found = 0;
+        for (int key : probes) {
+            found += tree.contains(key);
+        }
+        consume(found);
+    }));
+    reportNsPerOp(prefix + " remove", n, timeNs([&] {
+        for (int key : probes) {
+            tree.remove(key);
+        }
+    }));
+}
+
+/**
+ * [benchmarkScan - n / 100 scans of 100 keys each, from random starting keys]
+ */
+template<typename Tree>
+void benchmarkScan(const std::string &name, std::size_t n) {
+    const int width = 100;
+    std::vector<int> starts = generateKeys(n, KeyOrder::Random, 2);
+    starts.resize(n / width);
+    Tree tree;
+    for (int key : generateKeys(n, KeyOrder::Random)) {
+        tree.insert(key);
+    }
+
+    reportNsPerOp(name + " scan, per key", n, timeNs([&] {
+        std::uintptr_t sum = 0;
+        for (int start : starts) {
+            tree.for_each_in_range(start, start + width - 1, [&sum](int key) {
+                sum += key;
+            });
+        }
+        consume(sum);
+    }));
+}
+
+/**
+ * [benchmarkSizes - 10^3, 10^4, ... up to maxKeys]
+ */
+inline std::vector<std::size_t> benchmarkSizes(std::size_t maxKeys) {
+    std::vector<std::size_t> sizes;
+    for (std::size_t n = 1000; n <= maxKeys; n *= 10) {
+        sizes.push_back(n);
+    }
+    return sizes;
+}
+
+/**
+ * [benchmarkMaxKeys - largest tree size, the first argument if there is one]
+ */
+inline std::size_t benchmarkMaxKeys(int argc, char **argv, std::size_t defaultMax) {
+    return argc > 1 ? std::stoull(argv[1]) : defaultMax;
+}
+
+#endif //CRACKINGTHECODINGINTERVIEW_TREEBENCHMARK_H
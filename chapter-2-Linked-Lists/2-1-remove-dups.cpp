@@ -10,11 +10,16 @@
 #include <iostream>
 #include <unordered_map>
 #include <random>
+#include "ListGenerator.h"
 
 
 struct Node {
     int data = 0;
     Node *next = nullptr;
+
+    Node() = default;
+
+    Node(int d) : data{d} {}
 };
 
 /**
@@ -49,10 +54,8 @@ void printList(Node *head) {
  * @return     [A random number between min and max]
  */
 static inline int random_range(const int min, const int max) {
-    std::random_device rd;
-    std::mt19937 mt(rd());
     std::uniform_int_distribution<int> distribution(min, max);
-    return distribution(mt);
+    return distribution(randomEngine());
 }
 
 
@@ -72,7 +75,9 @@ void removeDuplicates(Node *head) {
         Node *runner = curr;
         while (runner->next != nullptr) {
             if (runner->next->data == curr->data) {
-                runner->next = runner->next->next;
+                Node *duplicate = runner->next;
+                runner->next = duplicate->next;
+                delete duplicate;
             } else {
                 runner = runner->next;
             }
@@ -98,7 +103,9 @@ void removeDuplicates1(Node *head) {
     node_map[head->data] = 1;
     while (curr != nullptr) {
         while (curr && node_map.find(curr->data) != node_map.end()) {
+            Node *duplicate = curr;
             curr = curr->next;
+            delete duplicate;
         }
         prev->next = curr;
         prev = curr;
@@ -109,8 +116,36 @@ void removeDuplicates1(Node *head) {
     }
 }
 
+/**
+ * [benchmark - time both methods on lists with many duplicates, and method 2 on a
+ *  sorted list, where every duplicate is next to the value it repeats]
+ * Method 1 is O(n^2) and only runs up to 10^4 nodes.
+ * @param maxNodes [largest list size]
+ */
+void benchmark(std::size_t maxNodes) {
+    for (std::size_t n : benchmarkSizes(maxNodes)) {
+        Node *head = duplicateList<Node>(n, static_cast<int>(n / 4));
+        reportNsPerNode("removeDuplicates1 (hash)", n, timeNs([&] { removeDuplicates1(head); }));
+        freeList(head);
+
+        head = sortedList<Node>(n);
+        reportNsPerNode("removeDuplicates1 (hash, sorted)", n, timeNs([&] { removeDuplicates1(head); }));
+        freeList(head);
+
+        if (n <= 10000) {
+            head = duplicateList<Node>(n, static_cast<int>(n / 4));
+            reportNsPerNode("removeDuplicates (runner)", n, timeNs([&] { removeDuplicates(head); }));
+            freeList(head);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    if (std::size_t maxNodes = benchmarkMaxNodes(argc, argv)) {
+        benchmark(maxNodes);
+        return 0;
+    }
 
-int main() {
     std::cout << "Method 1 : \n";
     Node *head = nullptr;
     for (int i = 0; i < 10; ++i) {
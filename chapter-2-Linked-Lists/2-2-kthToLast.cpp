@@ -17,9 +17,20 @@
  *  	 Solve the problem for n-1 nodes and add 1 to index.
  *  	 Since each parent call is adding 1, when counter reaches k,
  *  	 we have reached length-k node from start, which is kth node from last.
+ *
+ *  3. Tail window (streams of unknown length):
+ *  	 Keep the last k elements seen in a ring buffer of size k.
+ *  	 Works in a single pass with O(k) memory over any iterator range or stream,
+ *  	 and never recurses, so long lists do not overflow the stack.
+ *  	 Many k values can be answered in the same pass with a window of the largest k.
  */
 
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include "ListGenerator.h"
 
 struct Node {
     int data;
@@ -131,7 +142,176 @@ Node *kthToLastIterative(Node *head, int k) {
 }
 
 
-int main() {
+/**
+ * TailWindow - ring buffer holding the last k values pushed into it.
+ * push is O(1), kthToLast is O(1), memory is O(k).
+ */
+template<typename T>
+class TailWindow {
+public:
+    explicit TailWindow(std::size_t k) : capacity{k} {
+        buffer.reserve(k);
+    }
+
+    void push(const T &value) {
+        if (capacity == 0) {
+            return;
+        }
+        if (buffer.size() < capacity) {
+            buffer.push_back(value);
+        } else {
+            buffer[next] = value;
+        }
+        next = (next + 1 == capacity) ? 0 : next + 1;
+    }
+
+    /**
+     * number of values currently held, at most k
+     */
+    std::size_t size() const {
+        return buffer.size();
+    }
+
+    /**
+     * kthToLast - kth value from the end, 1 is the last value pushed.
+     * @param  k - must be in [1, size()]
+     */
+    const T &kthToLast(std::size_t k) const {
+        std::size_t idx = next >= k ? next - k : next + buffer.size() - k;
+        return buffer[idx];
+    }
+
+    /**
+     * values held, oldest first
+     */
+    std::vector<T> values() const {
+        std::vector<T> result;
+        result.reserve(buffer.size());
+        for (std::size_t k = buffer.size(); k > 0; --k) {
+            result.push_back(kthToLast(k));
+        }
+        return result;
+    }
+
+private:
+    std::size_t capacity;
+    std::size_t next = 0;   //slot the next push goes to
+    std::vector<T> buffer;
+};
+
+/**
+ * kthToLast - single pass kth to last over an iterator range.
+ * @return     - iterator to the kth element from last, or last if there are fewer than k.
+ */
+template<typename ForwardIt>
+ForwardIt kthToLast(ForwardIt first, ForwardIt last, std::size_t k) {
+    if (k == 0) {
+        return last;
+    }
+    TailWindow<ForwardIt> window(k);
+    for (; first != last; ++first) {
+        window.push(first);
+    }
+    return window.size() < k ? last : window.kthToLast(k);
+}
+
+/**
+ * kthToLastBatch - answers every k in ks in a single pass, using a window of max(ks).
+ * @return     - one iterator per k, last where the range is shorter than k.
+ */
+template<typename ForwardIt>
+std::vector<ForwardIt> kthToLastBatch(ForwardIt first, ForwardIt last, const std::vector<std::size_t> &ks) {
+    std::size_t maxK = ks.empty() ? 0 : *std::max_element(ks.begin(), ks.end());
+    TailWindow<ForwardIt> window(maxK);
+    for (; first != last; ++first) {
+        window.push(first);
+    }
+    std::vector<ForwardIt> result;
+    result.reserve(ks.size());
+    for (std::size_t k : ks) {
+        result.push_back(k == 0 || window.size() < k ? last : window.kthToLast(k));
+    }
+    return result;
+}
+
+/**
+ * lastK - the last k values read from a stream (or any input range), oldest first.
+ */
+template<typename T>
+std::vector<T> lastK(std::istream &in, std::size_t k) {
+    TailWindow<T> window(k);
+    for (std::istream_iterator<T> it(in), end; it != end; ++it) {
+        window.push(*it);
+    }
+    return window.values();
+}
+
+/**
+ * kthToLastWindow - Tail window approach for the kth to last element of list.
+ * @param  head  - head of node
+ * @param  k     - the k value for finding kth element from last of the list.
+ * @return       - kth node from last.
+ */
+Node *kthToLastWindow(Node *head, int k) {
+    if (k <= 0) {
+        return nullptr;
+    }
+    TailWindow<Node *> window(k);
+    for (; head; head = head->next) {
+        window.push(head);
+    }
+    return window.size() < static_cast<std::size_t>(k) ? nullptr : window.kthToLast(k);
+}
+
+/**
+ * kthToLastWindowBatch - kth to last node for every k in ks, in one pass over the list.
+ */
+std::vector<Node *> kthToLastWindowBatch(Node *head, const std::vector<std::size_t> &ks) {
+    std::size_t maxK = ks.empty() ? 0 : *std::max_element(ks.begin(), ks.end());
+    TailWindow<Node *> window(maxK);
+    for (; head; head = head->next) {
+        window.push(head);
+    }
+    std::vector<Node *> result;
+    result.reserve(ks.size());
+    for (std::size_t k : ks) {
+        result.push_back(k == 0 || window.size() < k ? nullptr : window.kthToLast(k));
+    }
+    return result;
+}
+
+
+/**
+ * benchmark - kth to last with k = 10 and k = n / 2 for each approach.
+ * The recursive approach recurses once per node and only runs up to 10^5 nodes.
+ * @param maxNodes - largest list size
+ */
+void benchmark(std::size_t maxNodes) {
+    for (std::size_t n : benchmarkSizes(maxNodes)) {
+        Node *head = randomList<Node>(n, 0, 1000);
+        for (int k : {10, static_cast<int>(n / 2)}) {
+            std::string suffix = " k=" + std::to_string(k);
+            if (n <= 100000) {
+                reportNsPerNode("kthToLastRecursive" + suffix, n, timeNs([&] {
+                    consume(reinterpret_cast<std::uintptr_t>(kthToLastRecursive(head, k)));
+                }));
+            }
+            reportNsPerNode("kthToLastIterative" + suffix, n, timeNs([&] {
+                consume(reinterpret_cast<std::uintptr_t>(kthToLastIterative(head, k)));
+            }));
+            reportNsPerNode("kthToLastWindow" + suffix, n, timeNs([&] {
+                consume(reinterpret_cast<std::uintptr_t>(kthToLastWindow(head, k)));
+            }));
+        }
+        freeList(head);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (std::size_t maxNodes = benchmarkMaxNodes(argc, argv)) {
+        benchmark(maxNodes);
+        return 0;
+    }
     Node *head = nullptr;
     for (int i = 7; i > 0; i--) {
         insert(head, i);
@@ -155,6 +335,34 @@ int main() {
         std::cout << "NULL NODE\n";
     }
 
+    std::cout << "4th node from last (Window) : ";
+    node4 = kthToLastWindow(head, 4);
+    if (node4 != nullptr) {
+        std::cout << node4->data << std::endl;
+    } else {
+        std::cout << "NULL NODE\n";
+    }
+
+    std::cout << "1st, 3rd, 7th and 9th from last (Window batch) : ";
+    for (Node *node : kthToLastWindowBatch(head, {1, 3, 7, 9})) {
+        if (node != nullptr) {
+            std::cout << node->data << " ";
+        } else {
+            std::cout << "NULL ";
+        }
+    }
+    std::cout << std::endl;
+
+    std::vector<int> values = {10, 20, 30, 40, 50};
+    std::cout << "2nd from last of vector : " << *kthToLast(values.begin(), values.end(), 2) << std::endl;
+
+    std::istringstream stream("5 8 13 21 34 55 89");
+    std::cout << "Last 3 values of stream : ";
+    for (int v : lastK<int>(stream, 3)) {
+        std::cout << v << " ";
+    }
+    std::cout << std::endl;
+
     deleteList(head);
 
     return 0;
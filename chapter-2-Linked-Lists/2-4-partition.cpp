@@ -16,6 +16,7 @@
 
 #include <iostream>
 #include <random>
+#include "ListGenerator.h"
 
 struct Node {
     int data;
@@ -81,7 +82,23 @@ Node *partition(Node *listhead, int x) {
 }
 
 
-int main() {
+/**
+ * [benchmark - partition random lists in [0, 99] around 50]
+ * @param maxNodes [largest list size]
+ */
+void benchmark(std::size_t maxNodes) {
+    for (std::size_t n : benchmarkSizes(maxNodes)) {
+        Node *head = randomList<Node>(n, 0, 99);
+        reportNsPerNode("partition", n, timeNs([&] { head = partition(head, 50); }));
+        freeList(head);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (std::size_t maxNodes = benchmarkMaxNodes(argc, argv)) {
+        benchmark(maxNodes);
+        return 0;
+    }
     Node *head = nullptr;
     for (int i = 0; i < 10; ++i) {
         insert(head, rand() % 9);
@@ -20,6 +20,7 @@
  */
 
 #include <iostream>
+#include "ListGenerator.h"
 
 struct Node {
     int data;
@@ -222,8 +223,34 @@ void deleteList(Node *&head) {
         head = nextNode;
     }
 }
+/**
+ * [benchmark - add two random n digit numbers]
+ * The recursive solutions recurse once per digit and only run up to 10^5 nodes.
+ * @param maxNodes [largest list size]
+ */
+void benchmark(std::size_t maxNodes) {
+    for (std::size_t n : benchmarkSizes(maxNodes)) {
+        Node *list1 = randomList<Node>(n, 0, 9);
+        Node *list2 = randomList<Node>(n, 0, 9);
+        Node *sum = nullptr;
+        reportNsPerNode("add_iterative", n, timeNs([&] { sum = add_iterative(list1, list2); }));
+        deleteList(sum);
+        if (n <= 100000) {
+            reportNsPerNode("add_recursive", n, timeNs([&] { sum = add_recursive(list1, list2, 0); }));
+            deleteList(sum);
+            reportNsPerNode("add_followup", n, timeNs([&] { sum = add_followup(list1, list2); }));
+            deleteList(sum);
+        }
+        deleteList(list1);
+        deleteList(list2);
+    }
+}
 
-int main() {
+int main(int argc, char **argv) {
+    if (std::size_t maxNodes = benchmarkMaxNodes(argc, argv)) {
+        benchmark(maxNodes);
+        return 0;
+    }
     //making list 1 for number 617
     Node *list1 = nullptr;
     insert(list1, 6);
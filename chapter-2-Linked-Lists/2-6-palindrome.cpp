@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <stack>
+#include "ListGenerator.h"
 
 struct Node {
     char data;
@@ -199,7 +200,28 @@ bool isPalindromeRecur(Node *head) {
 }
 
 
-int main() {
+/**
+ * [benchmark - run every approach on palindromes of n characters]
+ * The recursive approach recurses once per node and only runs up to 10^5 nodes.
+ * @param maxNodes [largest list size]
+ */
+void benchmark(std::size_t maxNodes) {
+    for (std::size_t n : benchmarkSizes(maxNodes)) {
+        Node *head = palindromeList<Node>(n, 'a', 'z');
+        reportNsPerNode("isPalindromeIter1 (reverse)", n, timeNs([&] { consume(isPalindromeIter1(head)); }));
+        reportNsPerNode("isPalindromeIter2 (stack)", n, timeNs([&] { consume(isPalindromeIter2(head)); }));
+        if (n <= 100000) {
+            reportNsPerNode("isPalindromeRecur", n, timeNs([&] { consume(isPalindromeRecur(head)); }));
+        }
+        freeList(head);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (std::size_t maxNodes = benchmarkMaxNodes(argc, argv)) {
+        benchmark(maxNodes);
+        return 0;
+    }
     Node *head1 = nullptr;
     insert(head1, 'a');
     insert(head1, 'b');
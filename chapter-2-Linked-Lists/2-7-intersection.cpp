@@ -4,10 +4,24 @@
  * Given two linked lists, if they both intersect at some point.
  * Find out the intersecting point else return nullptr.
  * Intersection is defined based on reference not value.
+ *
+ * Follow up (many lists):
+ * When thousands of lists are checked against each other, walking both lists
+ * for every pair is wasteful. IntersectionIndex walks every node exactly once
+ * and records, in a flat hash table, the first list that reached it. A list
+ * stops walking as soon as it hits a node owned by an earlier list, which
+ * gives a tree of lists (child list merges into its parent at a known position).
+ * Two lists intersect iff they end in the same tail, and their intersection is
+ * found from the lowest common ancestor of the two lists in that tree, which is
+ * answered in O(1) with a sparse table over the DFS order.
  */
 
 #include <iostream>
 #include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ListGenerator.h"
 
 struct Node {
     int data;
@@ -70,7 +84,298 @@ Node *intersectionPoint(Node *head1, Node *head2) {
 }
 
 
-int main() {
+/**
+ * [IntersectionIndex - answers intersection queries over a fixed set of lists]
+ * Build cost is O(total nodes + L log L) for L lists, each node is visited once.
+ * Pair queries are O(1), a query over a group of g lists is O(g).
+ * The lists must not be modified while the index is in use.
+ */
+class IntersectionIndex {
+public:
+    explicit IntersectionIndex(const std::vector<Node *> &heads) : heads(heads) {
+        const int numLists = static_cast<int>(heads.size());
+        parent.assign(numLists, -1);
+        entry.assign(numLists, 0);
+        tail.assign(numLists, nullptr);
+        offset.assign(numLists + 1, 0);
+
+        //size the table for the worst case of no shared nodes, so it is
+        //never rehashed while walking.
+        std::size_t total = 0;
+        for (Node *head : heads) {
+            total += listLen(head);
+        }
+        std::size_t capacity = 16;
+        while (capacity < 2 * total) {
+            capacity <<= 1;
+        }
+        table.assign(capacity, Slot{});
+        mask = capacity - 1;
+        nodes.reserve(total);
+
+        for (int list = 0; list < numLists; ++list) {
+            Node *curr = heads[list];
+            int pos = 0;
+            while (curr) {
+                Slot &slot = findSlot(curr);
+                if (slot.node) {
+                    //the rest of this list belongs to an earlier list
+                    parent[list] = slot.list;
+                    entry[list] = slot.pos;
+                    tail[list] = tail[slot.list];
+                    break;
+                }
+                slot.node = curr;
+                slot.list = list;
+                slot.pos = pos++;
+                nodes.push_back(curr);
+                tail[list] = curr;
+                curr = curr->next;
+            }
+            offset[list + 1] = static_cast<int>(nodes.size());
+        }
+        buildLca(numLists);
+    }
+
+    /**
+     * [intersects - O(1) check whether two lists share any node]
+     */
+    bool intersects(int list1, int list2) const {
+        return tail[list1] != nullptr && tail[list1] == tail[list2];
+    }
+
+    /**
+     * [intersectionPoint - O(1) version of the pairwise intersectionPoint]
+     * @return  [ First node shared by both lists, else nullptr]
+     */
+    Node *intersectionPoint(int list1, int list2) const {
+        if (!intersects(list1, list2)) {
+            return nullptr;
+        }
+        if (list1 == list2) {
+            //not nodeAt(list1, 0): a list that is a suffix of an earlier one owns no nodes
+            return heads[list1];
+        }
+        int u = list1;
+        int v = list2;
+        if (tin[u] > tin[v]) {
+            std::swap(u, v);
+        }
+        //child of the common ancestor on the path to v
+        int childV = minDepth(tin[u] + 1, tin[v]);
+        int lca = parent[childV];
+        if (lca == u) {
+            return nodeAt(lca, entry[childV]);
+        }
+        int childU = minDepth(tin[lca] + 1, tin[u]);
+        return nodeAt(lca, std::max(entry[childU], entry[childV]));
+    }
+
+    /**
+     * [intersectionPoint - first node shared by every list in the group]
+     * @return  [ Common node, nullptr if the group is empty or has no common node]
+     */
+    Node *intersectionPoint(const std::vector<int> &group) const {
+        if (group.empty()) {
+            return nullptr;
+        }
+        int first = group[0];
+        int last = group[0];
+        for (int list : group) {
+            if (!intersects(list, group[0])) {
+                return nullptr;
+            }
+            if (tin[list] < tin[first]) {
+                first = list;
+            }
+            if (tin[list] > tin[last]) {
+                last = list;
+            }
+        }
+        if (first == last) {
+            return heads[first];
+        }
+        //the lca of a group is the lca of its first and last list in dfs order
+        int lca = parent[minDepth(tin[first] + 1, tin[last])];
+        int pos = 0;
+        for (int list : group) {
+            if (list != lca) {
+                pos = std::max(pos, entry[minDepth(tin[lca] + 1, tin[list])]);
+            }
+        }
+        return nodeAt(lca, pos);
+    }
+
+private:
+    struct Slot {
+        Node *node = nullptr;
+        int list = 0;
+        int pos = 0;
+    };
+
+    Node *nodeAt(int list, int pos) const {
+        return nodes[offset[list] + pos];
+    }
+
+    Slot &findSlot(Node *node) {
+        auto h = reinterpret_cast<std::uintptr_t>(node);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        std::size_t i = h & mask;
+        while (table[i].node && table[i].node != node) {
+            i = (i + 1) & mask;
+        }
+        return table[i];
+    }
+
+    /**
+     * [buildLca - dfs order of the list tree plus a sparse table over it]
+     * For u before v in dfs order (u != v) the shallowest list in (tin[u], tin[v]]
+     * is the child of lca(u, v) that leads to v. Ties go to the later list.
+     */
+    void buildLca(int numLists) {
+        std::vector<int> childStart(numLists + 1, 0);
+        std::vector<int> children(numLists);
+        for (int list = 0; list < numLists; ++list) {
+            if (parent[list] >= 0) {
+                childStart[parent[list] + 1]++;
+            }
+        }
+        for (int list = 0; list < numLists; ++list) {
+            childStart[list + 1] += childStart[list];
+        }
+        std::vector<int> fill(childStart.begin(), childStart.end() - 1);
+        for (int list = 0; list < numLists; ++list) {
+            if (parent[list] >= 0) {
+                children[fill[parent[list]]++] = list;
+            }
+        }
+
+        tin.assign(numLists, 0);
+        depth.assign(numLists, 0);
+        order.clear();
+        order.reserve(numLists);
+        std::vector<int> stack;
+        for (int root = 0; root < numLists; ++root) {
+            if (parent[root] >= 0) {
+                continue;
+            }
+            stack.push_back(root);
+            while (!stack.empty()) {
+                int list = stack.back();
+                stack.pop_back();
+                tin[list] = static_cast<int>(order.size());
+                order.push_back(list);
+                for (int c = childStart[list]; c < childStart[list + 1]; ++c) {
+                    depth[children[c]] = depth[list] + 1;
+                    stack.push_back(children[c]);
+                }
+            }
+        }
+
+        sparse.assign(1, order);
+        for (int k = 1; (1 << k) <= numLists; ++k) {
+            const std::vector<int> &prev = sparse[k - 1];
+            std::vector<int> level(numLists - (1 << k) + 1);
+            for (std::size_t i = 0; i < level.size(); ++i) {
+                level[i] = shallower(prev[i], prev[i + (1 << (k - 1))]);
+            }
+            sparse.push_back(std::move(level));
+        }
+    }
+
+    int shallower(int a, int b) const {
+        return depth[a] < depth[b] || (depth[a] == depth[b] && tin[a] > tin[b]) ? a : b;
+    }
+
+    //shallowest list in dfs positions [lo, hi]
+    int minDepth(int lo, int hi) const {
+        int k = 31 - __builtin_clz(hi - lo + 1);
+        return shallower(sparse[k][lo], sparse[k][hi - (1 << k) + 1]);
+    }
+
+    std::vector<Node *> heads;
+    std::vector<Slot> table;
+    std::size_t mask = 0;
+    std::vector<Node *> nodes;  //nodes owned by each list, CSR layout
+    std::vector<int> offset;
+    std::vector<int> parent;    //list this one merges into, -1 if none
+    std::vector<int> entry;     //position in parent's own nodes where it merges
+    std::vector<Node *> tail;
+    std::vector<int> tin;
+    std::vector<int> depth;
+    std::vector<int> order;
+    std::vector<std::vector<int>> sparse;
+};
+
+/**
+ * [benchmarkOnePair - one pair of lists of n / 2 nodes each, pairwise walk against
+ *  building the index and querying it once]
+ */
+void benchmarkOnePair(std::size_t maxNodes) {
+    for (std::size_t n : benchmarkSizes(maxNodes)) {
+        std::vector<Node *> heads = sharedSuffixLists<Node>(2, n / 2, 0.0);
+        reportNsPerNode("intersectionPoint", n, timeNs([&] {
+            consume(reinterpret_cast<std::uintptr_t>(intersectionPoint(heads[0], heads[1])));
+        }));
+        reportNsPerNode("IntersectionIndex build+query", n, timeNs([&] {
+            IntersectionIndex index(heads);
+            consume(reinterpret_cast<std::uintptr_t>(index.intersectionPoint(0, 1)));
+        }));
+        freeList(heads[0], n / 2);
+        freeList(heads[1], n / 2);
+    }
+}
+
+/**
+ * [benchmarkAllPairs - all-pairs intersection: pairwise walks against IntersectionIndex]
+ */
+void benchmarkAllPairs(std::size_t numLists, std::size_t ownLen) {
+    std::vector<Node *> heads = sharedSuffixLists<Node>(numLists, ownLen);
+    const double pairs = static_cast<double>(numLists) * numLists;
+
+    std::uintptr_t checksum1 = 0;
+    double pairwiseNs = timeNs([&] {
+        for (Node *head1 : heads) {
+            for (Node *head2 : heads) {
+                checksum1 += reinterpret_cast<std::uintptr_t>(intersectionPoint(head1, head2));
+            }
+        }
+    });
+
+    IntersectionIndex index{std::vector<Node *>()};
+    double buildNs = timeNs([&] { index = IntersectionIndex(heads); });
+
+    std::uintptr_t checksum2 = 0;
+    double indexNs = timeNs([&] {
+        for (std::size_t i = 0; i < numLists; ++i) {
+            for (std::size_t j = 0; j < numLists; ++j) {
+                checksum2 += reinterpret_cast<std::uintptr_t>(index.intersectionPoint(i, j));
+            }
+        }
+    });
+
+    std::cout << numLists << " lists x " << ownLen << " own nodes, " << pairs << " pairs\n"
+              << "  pairwise walks : " << pairwiseNs / pairs << " ns/pair\n"
+              << "  index build    : " << buildNs / 1e6 << " ms\n"
+              << "  index queries  : " << indexNs / pairs << " ns/pair\n"
+              << "  results " << (checksum1 == checksum2 ? "match" : "DIFFER") << std::endl;
+    for (Node *head : heads) {
+        freeList(head, ownLen);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (std::size_t maxNodes = benchmarkMaxNodes(argc, argv)) {
+        std::size_t numLists = argc > 3 ? std::stoull(argv[3]) : 1000;
+        std::size_t ownLen = argc > 4 ? std::stoull(argv[4]) : 100;
+        benchmarkOnePair(maxNodes);
+        benchmarkAllPairs(numLists, ownLen);
+        return 0;
+    }
+
+
     Node *list1 = new Node(3);
     list1->next = new Node(6);
     list1->next->next = new Node(9);
@@ -91,5 +396,19 @@ int main() {
     } else {
         std::cout << "Lists do not interset" << std::endl;
     }
+
+    Node *list3 = new Node(1);
+    list3->next = list1->next->next->next->next;
+    IntersectionIndex index({list1, list2, list3, new Node(4)});
+    std::cout << "Index: list2 and list3 meet at " << index.intersectionPoint(1, 2)->data << std::endl;
+    std::cout << "Index: all three lists meet at " << index.intersectionPoint({0, 1, 2})->data << std::endl;
+    std::cout << "Index: list1 and list4 " << (index.intersects(0, 3) ? "intersect" : "do not intersect")
+              << std::endl;
+
+    //list2 of this index is a pure suffix of list1, so it owns no nodes of its own
+    IntersectionIndex suffixIndex({list1, list1->next, new Node(0)});
+    std::cout << "Suffix index: list2 with itself meets at " << suffixIndex.intersectionPoint(1, 1)->data
+              << ", as a group of one at " << suffixIndex.intersectionPoint({1})->data
+              << ", with list1 at " << suffixIndex.intersectionPoint(0, 1)->data << std::endl;
     return 0;
 }
@@ -4,9 +4,22 @@
  *  Problem : Determine if a linkedlist has a loop. If it has a loop, find the start of loop.
  *  NOTE: I have followed the approach provided in book, however, once I find start of loop,
  *  I remove the loop. So that we can test our solution. Read comment at line 25.
+ *
+ *  Follow up (functional graphs):
+ *  brentCycle uses Brent's algorithm, which needs fewer pointer moves than Floyd's and
+ *  reports the cycle start, the cycle length and the tail length without changing the list.
+ *  The same is provided over a next[] array, where next[i] == -1 ends the list.
+ *  findAllCycles finds every cycle of a functional graph by colouring each node with the
+ *  id of the walk that reached it first, so every node is visited once in total.
  */
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ListGenerator.h"
 
 struct Node {
     int data;
@@ -44,6 +57,228 @@ bool detectAndRemoveCycle(Node *head) {
 }
 
 
+/**
+ * Result of a cycle analysis. For an acyclic list tailLength is the list length.
+ */
+template<typename Ref>
+struct CycleInfo {
+    bool hasCycle = false;
+    Ref start{};            //first node of the cycle
+    long long cycleLength = 0;
+    long long tailLength = 0;   //nodes before the cycle start
+};
+
+/**
+ * [brentCycle - Brent's cycle detection on a linked list, the list is not modified]
+ * @param head - head of the list
+ * @return     - cycle start, cycle length and tail length
+ */
+CycleInfo<Node *> brentCycle(Node *head) {
+    CycleInfo<Node *> info;
+    if (head == nullptr) {
+        return info;
+    }
+    //find the cycle length: the hare moves, the tortoise teleports to it
+    //every power of two steps.
+    long long power = 1;
+    long long length = 1;
+    Node *tortoise = head;
+    Node *hare = head->next;
+    while (hare != tortoise) {
+        if (hare == nullptr) {
+            for (Node *curr = head; curr; curr = curr->next) {
+                info.tailLength++;
+            }
+            return info;
+        }
+        if (power == length) {
+            tortoise = hare;
+            power *= 2;
+            length = 0;
+        }
+        hare = hare->next;
+        ++length;
+    }
+    //hare starts length nodes ahead, they meet at the start of the cycle.
+    tortoise = hare = head;
+    for (long long i = 0; i < length; ++i) {
+        hare = hare->next;
+    }
+    long long tail = 0;
+    while (tortoise != hare) {
+        tortoise = tortoise->next;
+        hare = hare->next;
+        ++tail;
+    }
+    info.hasCycle = true;
+    info.start = tortoise;
+    info.cycleLength = length;
+    info.tailLength = tail;
+    return info;
+}
+
+/**
+ * [brentCycle - Brent's cycle detection over a next[] array]
+ * @param next  - next[i] is the successor of i, -1 for none
+ * @param start - index to start walking from
+ */
+CycleInfo<int> brentCycle(const int *next, int start) {
+    CycleInfo<int> info;
+    info.start = -1;
+    if (start < 0) {
+        return info;
+    }
+    long long power = 1;
+    long long length = 1;
+    int tortoise = start;
+    int hare = next[start];
+    while (hare != tortoise) {
+        if (hare < 0) {
+            for (int curr = start; curr >= 0; curr = next[curr]) {
+                info.tailLength++;
+            }
+            return info;
+        }
+        if (power == length) {
+            tortoise = hare;
+            power *= 2;
+            length = 0;
+        }
+        hare = next[hare];
+        ++length;
+    }
+    tortoise = hare = start;
+    for (long long i = 0; i < length; ++i) {
+        hare = next[hare];
+    }
+    long long tail = 0;
+    while (tortoise != hare) {
+        tortoise = next[tortoise];
+        hare = next[hare];
+        ++tail;
+    }
+    info.hasCycle = true;
+    info.start = tortoise;
+    info.cycleLength = length;
+    info.tailLength = tail;
+    return info;
+}
+
+/**
+ * A cycle of a functional graph, start is the smallest index on the cycle.
+ */
+struct Cycle {
+    int start;
+    int length;
+
+    bool operator<(const Cycle &other) const {
+        return start < other.start;
+    }
+};
+
+/**
+ * [cycleFrom - canonical description of the cycle going through node]
+ */
+Cycle cycleFrom(const int *next, int node) {
+    Cycle cycle{node, 1};
+    for (int curr = next[node]; curr != node; curr = next[curr]) {
+        cycle.start = std::min(cycle.start, curr);
+        cycle.length++;
+    }
+    return cycle;
+}
+
+/**
+ * [findAllCycles - every cycle of the functional graph next[0..n), -1 ends a path]
+ * Walks start from every uncoloured node. A walk claims nodes with its own colour
+ * (start index + 1) and stops at the first coloured node or at -1. A walk that stops
+ * on its own colour has closed a cycle.
+ *
+ * With threads > 1 the start nodes are split between threads and nodes are claimed
+ * with a compare-and-swap. A cycle may then be claimed piecewise by several walks
+ * which stop on each other; those walks form a cycle in the "walk stopped on walk"
+ * graph, which is resolved sequentially afterwards. Total work stays O(n).
+ * @return cycles sorted by start
+ */
+std::vector<Cycle> findAllCycles(const int *next, int n, unsigned threads = 1) {
+    std::vector<Cycle> cycles;
+    if (threads <= 1) {
+        std::vector<int> colour(n, 0);
+        for (int start = 0; start < n; ++start) {
+            int curr = start;
+            while (curr >= 0 && colour[curr] == 0) {
+                colour[curr] = start + 1;
+                curr = next[curr];
+            }
+            if (curr >= 0 && colour[curr] == start + 1) {
+                cycles.push_back(cycleFrom(next, curr));
+            }
+        }
+        std::sort(cycles.begin(), cycles.end());
+        return cycles;
+    }
+
+    std::vector<std::atomic<int>> colour(n);
+    for (auto &c : colour) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    //node a walk stopped on, -1 for none. Indexed by the walk's start.
+    std::vector<int> stoppedAt(n, -1);
+    std::vector<std::vector<Cycle>> found(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            int lo = static_cast<int>(static_cast<long long>(n) * t / threads);
+            int hi = static_cast<int>(static_cast<long long>(n) * (t + 1) / threads);
+            for (int start = lo; start < hi; ++start) {
+                int curr = start;
+                int owner = 0;
+                while (curr >= 0) {
+                    int expected = 0;
+                    if (!colour[curr].compare_exchange_strong(expected, start + 1,
+                                                               std::memory_order_relaxed)) {
+                        owner = expected;
+                        break;
+                    }
+                    curr = next[curr];
+                }
+                if (curr < 0 || owner == 0) {
+                    continue;
+                }
+                if (owner == start + 1) {
+                    found[t].push_back(cycleFrom(next, curr));
+                } else if (curr != start) {
+                    //walks that failed to claim their start node are not recorded
+                    stoppedAt[start] = curr;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (auto &part : found) {
+        cycles.insert(cycles.end(), part.begin(), part.end());
+    }
+
+    //walk w points at the walk owning stoppedAt[w]. Cycles among walks are cycles
+    //of the graph that no single walk closed.
+    std::vector<int> mark(n, 0);
+    for (int walk = 0; walk < n; ++walk) {
+        int curr = walk;
+        while (curr >= 0 && stoppedAt[curr] >= 0 && mark[curr] == 0) {
+            mark[curr] = walk + 1;
+            curr = colour[stoppedAt[curr]].load(std::memory_order_relaxed) - 1;
+        }
+        if (curr >= 0 && mark[curr] == walk + 1) {
+            cycles.push_back(cycleFrom(next, stoppedAt[curr]));
+        }
+    }
+    std::sort(cycles.begin(), cycles.end());
+    return cycles;
+}
+
+
 void insert(Node *&head, int data) {
     Node *newNode = new Node(data);
     if (head == nullptr) {
@@ -66,7 +301,53 @@ void printList(Node *head) {
 }
 
 
-int main() {
+/**
+ * [benchmark - Floyd (detectAndRemoveCycle) against Brent on a list with a cycle,
+ *  then Brent and the colouring passes over a random functional graph]
+ * @param maxNodes [largest list size]
+ */
+void benchmark(std::size_t maxNodes) {
+    std::vector<unsigned> threadCounts = {1};
+    if (std::thread::hardware_concurrency() > 1) {
+        threadCounts.push_back(std::thread::hardware_concurrency());
+    }
+    for (std::size_t n : benchmarkSizes(maxNodes)) {
+        //rho shaped list: n / 2 tail nodes, n / 2 cycle nodes
+        Node *head = cycleList<Node>(n, n / 2);
+        Node *last = nodeAt(head, n - 1);
+        Node *loopStart = last->next;
+        reportNsPerNode("floyd detectAndRemoveCycle", n, timeNs([&] { consume(detectAndRemoveCycle(head)); }));
+        last->next = loopStart;
+        reportNsPerNode("brentCycle (list)", n, timeNs([&] {
+            consume(reinterpret_cast<std::uintptr_t>(brentCycle(head).start));
+        }));
+        freeList(head, n);
+
+        //random functional graph
+        std::uniform_int_distribution<int> target(0, static_cast<int>(n) - 1);
+        std::vector<int> next(n);
+        for (int &successor : next) {
+            successor = target(randomEngine());
+        }
+        reportNsPerNode("brentCycle (array, from 0)", n, timeNs([&] {
+            consume(brentCycle(next.data(), 0).cycleLength);
+        }));
+        for (unsigned threads : threadCounts) {
+            reportNsPerNode("findAllCycles " + std::to_string(threads) + " thread(s)", n, timeNs([&] {
+                consume(findAllCycles(next.data(), static_cast<int>(n), threads).size());
+            }));
+        }
+    }
+}
+
+
+int main(int argc, char **argv) {
+    if (std::size_t maxNodes = benchmarkMaxNodes(argc, argv)) {
+        benchmark(maxNodes);
+        return 0;
+    }
+
+
     Node *head = nullptr;
     insert(head, 1);
     insert(head, 2);
@@ -77,9 +358,19 @@ int main() {
     printList(head);
     std::cout << "Inserting loop, connecting 5 to 2 \n";
     head->next->next->next->next->next = head->next;
+    CycleInfo<Node *> info = brentCycle(head);
+    std::cout << "Brent: loop starts at " << info.start->data << ", length " << info.cycleLength
+              << ", tail length " << info.tailLength << "\n";
     std::cout << "Detecting and deleting loop\n";
     detectAndRemoveCycle(head);
     std::cout << "Back to the same old list\n";
     printList(head);
+
+    // 0 -> 1 -> 2 -> 0 and 3 -> 4 -> 4, 5 -> 2
+    int next[] = {1, 2, 0, 4, 4, 2};
+    std::cout << "Cycles of the functional graph:\n";
+    for (const Cycle &cycle : findAllCycles(next, 6, 2)) {
+        std::cout << "  start " << cycle.start << ", length " << cycle.length << "\n";
+    }
     return 0;
 }
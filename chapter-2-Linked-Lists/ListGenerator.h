@@ -0,0 +1,207 @@
+/**
+ * Shared dataset generator and timing helpers for the chapter 2 benchmarks.
+ *
+ * Every solution in this chapter defines its own Node type, so the generators are
+ * templated on it. The only requirements are a `next` pointer and a constructor taking
+ * the node's data. Lists are built front to back with a tail pointer, so building a
+ * list of n nodes is O(n), and all random values come from a single engine.
+ */
+
+#ifndef CRACKINGTHECODINGINTERVIEW_LISTGENERATOR_H
+#define CRACKINGTHECODINGINTERVIEW_LISTGENERATOR_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * [randomEngine - the engine shared by every generator, seeded once]
+ */
+inline std::mt19937 &randomEngine() {
+    static std::mt19937 mt(std::random_device{}());
+    return mt;
+}
+
+/**
+ * [generateList - build a list of n nodes, node i holds valueAt(i)]
+ * @return     [head of the list, nullptr for n == 0]
+ */
+template<typename Node, typename ValueAt>
+Node *generateList(std::size_t n, ValueAt valueAt) {
+    Node *head = nullptr;
+    Node *tail = nullptr;
+    for (std::size_t i = 0; i < n; ++i) {
+        Node *node = new Node(valueAt(i));
+        if (tail) {
+            tail->next = node;
+        } else {
+            head = node;
+        }
+        tail = node;
+    }
+    return head;
+}
+
+/**
+ * [randomList - n values drawn uniformly from [min, max]]
+ */
+template<typename Node>
+Node *randomList(std::size_t n, int min, int max) {
+    std::uniform_int_distribution<int> distribution(min, max);
+    return generateList<Node>(n, [&](std::size_t) { return distribution(randomEngine()); });
+}
+
+/**
+ * [sortedList - n non-decreasing values with random gaps]
+ */
+template<typename Node>
+Node *sortedList(std::size_t n) {
+    std::uniform_int_distribution<int> gap(0, 3);
+    int value = 0;
+    return generateList<Node>(n, [&](std::size_t) { return value += gap(randomEngine()); });
+}
+
+/**
+ * [duplicateList - n values drawn from only `distinct` different values]
+ */
+template<typename Node>
+Node *duplicateList(std::size_t n, int distinct) {
+    return randomList<Node>(n, 0, std::max(distinct, 1) - 1);
+}
+
+/**
+ * [palindromeList - n random values in [min, max] that read the same both ways]
+ */
+template<typename Node>
+Node *palindromeList(std::size_t n, int min, int max) {
+    std::uniform_int_distribution<int> distribution(min, max);
+    std::vector<int> half((n + 1) / 2);
+    for (int &value : half) {
+        value = distribution(randomEngine());
+    }
+    return generateList<Node>(n, [&](std::size_t i) { return half[std::min(i, n - 1 - i)]; });
+}
+
+/**
+ * [nodeAt - the node i steps from head]
+ */
+template<typename Node>
+Node *nodeAt(Node *head, std::size_t i) {
+    while (i-- > 0 && head) {
+        head = head->next;
+    }
+    return head;
+}
+
+/**
+ * [cycleList - n random nodes where the last node links back to node tailLength]
+ * The list has tailLength nodes before the cycle and n - tailLength on it.
+ */
+template<typename Node>
+Node *cycleList(std::size_t n, std::size_t tailLength) {
+    Node *head = randomList<Node>(n, 0, 1000);
+    if (n > 0) {
+        nodeAt(head, n - 1)->next = nodeAt(head, std::min(tailLength, n - 1));
+    }
+    return head;
+}
+
+/**
+ * [sharedSuffixLists - numLists lists that share suffixes]
+ * Every list starts with ownLength fresh nodes, then joins a random node of a random
+ * earlier list. A fraction of the lists (independentFraction) ends on its own instead,
+ * so not every pair intersects.
+ */
+template<typename Node>
+std::vector<Node *> sharedSuffixLists(std::size_t numLists, std::size_t ownLength,
+                                      double independentFraction = 0.125) {
+    std::bernoulli_distribution independent(independentFraction);
+    std::vector<Node *> heads;
+    heads.reserve(numLists);
+    for (std::size_t list = 0; list < numLists; ++list) {
+        Node *head = randomList<Node>(ownLength, 0, 1000);
+        if (list > 0 && ownLength > 0 && !independent(randomEngine())) {
+            std::uniform_int_distribution<std::size_t> pickList(0, list - 1);
+            std::uniform_int_distribution<std::size_t> pickNode(0, ownLength - 1);
+            nodeAt(head, ownLength - 1)->next = nodeAt(heads[pickList(randomEngine())], pickNode(randomEngine()));
+        }
+        heads.push_back(head);
+    }
+    return heads;
+}
+
+/**
+ * [freeList - delete at most count nodes starting at head]
+ * Bounding the count makes this safe for lists with a cycle or a shared suffix.
+ */
+template<typename Node>
+void freeList(Node *head, std::size_t count = SIZE_MAX) {
+    while (head && count-- > 0) {
+        Node *nextNode = head->next;
+        delete head;
+        head = nextNode;
+    }
+}
+
+/**
+ * [timeNs - wall clock time of fn in nanoseconds]
+ */
+template<typename Fn>
+double timeNs(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * [consume - keep a benchmark result alive so the work is not optimised away]
+ */
+inline volatile std::uintptr_t &benchmarkSink() {
+    static volatile std::uintptr_t sink = 0;
+    return sink;
+}
+
+inline void consume(std::uintptr_t value) {
+    benchmarkSink() = value;
+}
+
+/**
+ * [reportNsPerNode - print one benchmark line]
+ */
+inline void reportNsPerNode(const std::string &name, std::size_t n, double ns) {
+    std::ostringstream line;
+    line << std::left << std::setw(32) << name << std::right << std::setw(12) << n
+         << std::setw(12) << std::fixed << std::setprecision(2) << ns / n << " ns/node";
+    std::cout << line.str() << std::endl;
+}
+
+/**
+ * [benchmarkSizes - 10^3, 10^4, ... up to maxNodes]
+ */
+inline std::vector<std::size_t> benchmarkSizes(std::size_t maxNodes) {
+    std::vector<std::size_t> sizes;
+    for (std::size_t n = 1000; n <= maxNodes; n *= 10) {
+        sizes.push_back(n);
+    }
+    return sizes;
+}
+
+/**
+ * [benchmarkMaxNodes - largest list size for a `--benchmark [maxNodes]` run]
+ * @return     [0 when the program was not started with --benchmark]
+ */
+inline std::size_t benchmarkMaxNodes(int argc, char **argv, std::size_t defaultMax = 10000000) {
+    if (argc < 2 || std::string(argv[1]) != "--benchmark") {
+        return 0;
+    }
+    return argc > 2 ? std::stoull(argv[2]) : defaultMax;
+}
+
+#endif //CRACKINGTHECODINGINTERVIEW_LISTGENERATOR_H